@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    BackgroundCache.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "BackgroundCache.h"
+
+juce::Image
+BackgroundCache::getImage(int width,
+                          int height,
+                          float scale,
+                          const std::function<void(juce::Graphics&)>& render)
+{
+  for (auto& entry : entries) {
+    if (entry.width == width && entry.height == height && entry.scale == scale)
+      return entry.image;
+  }
+
+  juce::Image image(juce::Image::PixelFormat::RGB,
+                    juce::roundToInt(width * scale),
+                    juce::roundToInt(height * scale),
+                    true);
+  {
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    render(g);
+  }
+
+  // the oldest image goes first
+  if (entries.size() == MaxImages)
+    entries.erase(entries.begin());
+
+  entries.push_back({ width, height, scale, image });
+  return image;
+}
+
+size_t
+BackgroundCache::getMemoryBytes() const
+{
+  size_t bytes = 0;
+  for (const auto& entry : entries) {
+    // RGB images are padded out to 4 bytes a pixel
+    auto pixels = size_t(entry.image.getWidth()) * entry.image.getHeight();
+    bytes += pixels * 4;
+  }
+
+  return bytes;
+}
@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    BackgroundCache.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/* Prerendered editor backgrounds, keyed by size and display scale and shared
+   by every instance in the process. The processor holds a reference too, so
+   the images outlive the editor and reopening it doesn't render them again.
+*/
+struct BackgroundCache
+{
+  // returns the cached image, calling 'render' to draw it on a miss. 'render'
+  // draws in component coordinates, the image holds width * scale by
+  // height * scale pixels
+  juce::Image getImage(int width,
+                       int height,
+                       float scale,
+                       const std::function<void(juce::Graphics&)>& render);
+
+  size_t getMemoryBytes() const;
+
+private:
+  static constexpr int MaxImages = 4;
+
+  struct Entry
+  {
+    int width, height;
+    float scale;
+    juce::Image image;
+  };
+
+  std::vector<Entry> entries;
+};
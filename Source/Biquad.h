@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    Biquad.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/* A second order section that drops into a juce::dsp::ProcessorChain in place
+   of juce::dsp::IIR::Filter. It runs the same transposed direct form II
+   arithmetic on the same coefficients, but its state is public, so it can be
+   saved and restored.
+*/
+struct Biquad
+{
+  using Coefficients = juce::dsp::IIR::Coefficients<float>;
+  using CoefficientsPtr = Coefficients::Ptr;
+
+  struct State
+  {
+    float z1{ 0 }, z2{ 0 };
+  };
+
+  // b0, b1, b2, a1, a2, starting out as a pass through
+  CoefficientsPtr coefficients{ new Coefficients(1, 0, 0, 1, 0, 0) };
+  State state;
+
+  void prepare(const juce::dsp::ProcessSpec&) { reset(); }
+  void reset() { state = {}; }
+
+  template<typename ProcessContext>
+  void process(const ProcessContext& context) noexcept
+  {
+    auto&& inputBlock = context.getInputBlock();
+    auto&& outputBlock = context.getOutputBlock();
+
+    jassert(inputBlock.getNumChannels() == 1);
+    jassert(outputBlock.getNumChannels() == 1);
+    jassert(inputBlock.getNumSamples() == outputBlock.getNumSamples());
+
+    if (context.isBypassed) {
+      if (context.usesSeparateInputAndOutputBlocks())
+        outputBlock.copyFrom(inputBlock);
+
+      return;
+    }
+
+    jassert(coefficients->coefficients.size() == 5);
+
+    const auto* c = coefficients->getRawCoefficients();
+    const auto b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+
+    auto* src = inputBlock.getChannelPointer(0);
+    auto* dst = outputBlock.getChannelPointer(0);
+    const auto numSamples = outputBlock.getNumSamples();
+
+    auto z1 = state.z1;
+    auto z2 = state.z2;
+
+    for (size_t i = 0; i < numSamples; ++i) {
+      auto in = src[i];
+      auto out = b0 * in + z1;
+      z1 = b1 * in - a1 * out + z2;
+      z2 = b2 * in - a2 * out;
+      dst[i] = out;
+    }
+
+    juce::dsp::util::snapToZero(z1);
+    juce::dsp::util::snapToZero(z2);
+
+    state.z1 = z1;
+    state.z2 = z2;
+  }
+};
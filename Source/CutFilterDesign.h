@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    CutFilterDesign.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+
+enum Slope
+{
+  Slope_12,
+  Slope_24,
+  Slope_36,
+  Slope_48,
+};
+
+constexpr int MaxCutFilterSections = 4;
+
+constexpr int
+getNumCutFilterSections(Slope slope)
+{
+  return static_cast<int>(slope) + 1;
+}
+
+namespace CutFilterDesign {
+constexpr double pi = 3.14159265358979323846;
+
+// Taylor series, accurate to double precision for 0 <= x <= pi / 2
+constexpr double
+cos(double x)
+{
+  double term = 1.0;
+  double sum = 1.0;
+  for (int n = 1; n < 12; ++n) {
+    term *= -x * x / double((2 * n - 1) * (2 * n));
+    sum += term;
+  }
+  return sum;
+}
+
+// Q of each biquad section of an even order Butterworth filter, the same
+// values juce::dsp::FilterDesign computes at runtime
+constexpr std::array<double, MaxCutFilterSections>
+makeSectionQs(int numSections)
+{
+  std::array<double, MaxCutFilterSections> qs{};
+  const int order = numSections * 2;
+  for (int i = 0; i < numSections; ++i) {
+    qs[i] = 1.0 / (2.0 * cos((2.0 * i + 1.0) * pi / (order * 2.0)));
+  }
+  return qs;
+}
+} // namespace CutFilterDesign
+
+// indexed by [Slope][section]
+constexpr std::array<std::array<double, MaxCutFilterSections>, 4>
+  butterworthSectionQs{ CutFilterDesign::makeSectionQs(1),
+                        CutFilterDesign::makeSectionQs(2),
+                        CutFilterDesign::makeSectionQs(3),
+                        CutFilterDesign::makeSectionQs(4) };
+
+static_assert(butterworthSectionQs[Slope_12][0] > 0.7071 &&
+                butterworthSectionQs[Slope_12][0] < 0.7072,
+              "a second order Butterworth section should have a Q of 1/sqrt(2)");
+
+/* Writes the biquad sections of a Butterworth low cut (high pass) or high cut
+   (low pass) straight into 'sections', one pointer per section to five floats
+   laid out as b0, b1, b2, a1, a2.
+   Only the first getNumCutFilterSections(slope) pointers are written to.
+   Costs one tan() per call and nothing is allocated.
+*/
+inline void
+designCutFilter(bool isHighCut,
+                double freq,
+                double sampleRate,
+                Slope slope,
+                float* const* sections)
+{
+  const auto& qs = butterworthSectionQs[slope];
+
+  // the same bilinear transform juce's makeHighPass/makeLowPass use
+  auto k = std::tan(CutFilterDesign::pi * freq / sampleRate);
+  auto n = isHighCut ? 1.0 / k : k;
+  auto nSquared = n * n;
+
+  for (int i = 0; i < getNumCutFilterSections(slope); ++i) {
+    auto invQ = 1.0 / qs[i];
+    auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    auto* c = sections[i];
+    c[0] = float(c1);
+    c[1] = float(isHighCut ? c1 * 2.0 : c1 * -2.0);
+    c[2] = float(c1);
+    c[3] = float(isHighCut ? c1 * 2.0 * (1.0 - nSquared)
+                           : c1 * 2.0 * (nSquared - 1.0));
+    c[4] = float(c1 * (1.0 - invQ * n + nSquared));
+  }
+}
+
+/* How long a biquad section ringing at 'freq' with the given pole Q takes to
+   decay by 'decayGain' (e.g. 1e-5 for 100 dB), from the slowest pole of its
+   analog prototype.
+*/
+inline double
+getSectionDecaySeconds(double freq, double q, double decayGain)
+{
+  auto w = 2.0 * CutFilterDesign::pi * freq;
+  auto damping = 1.0 / (2.0 * q);
+
+  // overdamped sections have a slower real pole
+  auto sigma = damping >= 1.0
+                 ? w * (damping - std::sqrt(damping * damping - 1.0))
+                 : w * damping;
+
+  return -std::log(decayGain) / sigma;
+}
+
+inline double
+getCutFilterDecaySeconds(double freq, Slope slope, double decayGain)
+{
+  // the last section has the highest Q, so it rings the longest
+  const auto& qs = butterworthSectionQs[slope];
+  return getSectionDecaySeconds(
+    freq, qs[getNumCutFilterSections(slope) - 1], decayGain);
+}
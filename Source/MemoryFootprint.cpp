@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    MemoryFootprint.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "MemoryFootprint.h"
+
+void
+MemoryFootprint::add(const juce::String& subsystem, size_t bytes, bool shared)
+{
+  entries.push_back({ subsystem, bytes, shared });
+}
+
+size_t
+MemoryFootprint::getTotalBytes(bool includeShared) const
+{
+  size_t total = 0;
+  for (const auto& entry : entries) {
+    if (includeShared || !entry.shared)
+      total += entry.bytes;
+  }
+
+  return total;
+}
+
+juce::String
+MemoryFootprint::toString() const
+{
+  auto sorted = entries;
+  std::stable_sort(
+    sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) {
+      return a.bytes > b.bytes;
+    });
+
+  juce::String str;
+  for (const auto& entry : sorted) {
+    str << entry.subsystem << (entry.shared ? " (shared)" : "") << ": "
+        << juce::File::descriptionOfSizeInBytes((juce::int64)entry.bytes)
+        << juce::newLine;
+  }
+
+  str << "Instance total: "
+      << juce::File::descriptionOfSizeInBytes(
+           (juce::int64)getTotalBytes(false))
+      << juce::newLine << "Including shared: "
+      << juce::File::descriptionOfSizeInBytes((juce::int64)getTotalBytes(true))
+      << juce::newLine;
+
+  return str;
+}
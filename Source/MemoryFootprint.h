@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    MemoryFootprint.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <vector>
+
+/* How much memory an instance holds, broken down by subsystem. The sizes are
+   what each subsystem asked for, not what the allocator rounded them up to.
+   Shared entries are held once per process, by every instance together.
+*/
+struct MemoryFootprint
+{
+  struct Entry
+  {
+    juce::String subsystem;
+    size_t bytes;
+    bool shared;
+  };
+
+  void add(const juce::String& subsystem, size_t bytes, bool shared = false);
+
+  const std::vector<Entry>& getEntries() const { return entries; }
+  size_t getTotalBytes(bool includeShared) const;
+
+  // one line per subsystem, largest first, then the totals
+  juce::String toString() const;
+
+private:
+  std::vector<Entry> entries;
+};
+
+inline size_t
+getMemoryBytes(const juce::AudioBuffer<float>& buffer)
+{
+  return size_t(buffer.getNumChannels()) * size_t(buffer.getNumSamples()) *
+         sizeof(float);
+}
+
+template<typename T>
+size_t
+getMemoryBytes(const std::vector<T>& vector)
+{
+  return vector.capacity() * sizeof(T);
+}
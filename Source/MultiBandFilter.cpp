@@ -0,0 +1,257 @@
+/*
+  ==============================================================================
+
+    MultiBandFilter.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "MultiBandFilter.h"
+
+#include <complex>
+
+bool
+operator==(const BandSettings& lhs, const BandSettings& rhs)
+{
+  return lhs.type == rhs.type && lhs.freq == rhs.freq &&
+         lhs.gainInDecibels == rhs.gainInDecibels &&
+         lhs.quality == rhs.quality && lhs.bypassed == rhs.bypassed;
+}
+
+bool
+operator!=(const BandSettings& lhs, const BandSettings& rhs)
+{
+  return !(lhs == rhs);
+}
+
+void
+designBand(const BandSettings& band,
+           double sampleRate,
+           BiquadCoefficients& coefficients)
+{
+  // RBJ audio EQ cookbook designs, computed in place so they are safe to call
+  // from the audio thread
+  using namespace juce;
+
+  auto freq = jlimit(1.0, sampleRate * 0.49, double(band.freq));
+  auto w0 = MathConstants<double>::twoPi * freq / sampleRate;
+  auto cosw = std::cos(w0);
+  auto alpha = std::sin(w0) / (2.0 * jmax(0.01, double(band.quality)));
+  auto A = std::pow(10.0, band.gainInDecibels / 40.0);
+  auto sqrtA2Alpha = 2.0 * std::sqrt(A) * alpha;
+
+  double b0 = 1, b1 = 0, b2 = 0, a0 = 1, a1 = 0, a2 = 0;
+
+  switch (band.type) {
+    case BandType_Peak: {
+      b0 = 1 + alpha * A;
+      b1 = -2 * cosw;
+      b2 = 1 - alpha * A;
+      a0 = 1 + alpha / A;
+      a1 = -2 * cosw;
+      a2 = 1 - alpha / A;
+      break;
+    }
+    case BandType_LowShelf: {
+      b0 = A * ((A + 1) - (A - 1) * cosw + sqrtA2Alpha);
+      b1 = 2 * A * ((A - 1) - (A + 1) * cosw);
+      b2 = A * ((A + 1) - (A - 1) * cosw - sqrtA2Alpha);
+      a0 = (A + 1) + (A - 1) * cosw + sqrtA2Alpha;
+      a1 = -2 * ((A - 1) + (A + 1) * cosw);
+      a2 = (A + 1) + (A - 1) * cosw - sqrtA2Alpha;
+      break;
+    }
+    case BandType_HighShelf: {
+      b0 = A * ((A + 1) + (A - 1) * cosw + sqrtA2Alpha);
+      b1 = -2 * A * ((A - 1) + (A + 1) * cosw);
+      b2 = A * ((A + 1) + (A - 1) * cosw - sqrtA2Alpha);
+      a0 = (A + 1) - (A - 1) * cosw + sqrtA2Alpha;
+      a1 = 2 * ((A - 1) - (A + 1) * cosw);
+      a2 = (A + 1) - (A - 1) * cosw - sqrtA2Alpha;
+      break;
+    }
+    case BandType_Notch: {
+      b0 = 1;
+      b1 = -2 * cosw;
+      b2 = 1;
+      a0 = 1 + alpha;
+      a1 = -2 * cosw;
+      a2 = 1 - alpha;
+      break;
+    }
+    case BandType_LowCut: {
+      b0 = (1 + cosw) / 2;
+      b1 = -(1 + cosw);
+      b2 = (1 + cosw) / 2;
+      a0 = 1 + alpha;
+      a1 = -2 * cosw;
+      a2 = 1 - alpha;
+      break;
+    }
+    case BandType_HighCut: {
+      b0 = (1 - cosw) / 2;
+      b1 = 1 - cosw;
+      b2 = (1 - cosw) / 2;
+      a0 = 1 + alpha;
+      a1 = -2 * cosw;
+      a2 = 1 - alpha;
+      break;
+    }
+  }
+
+  coefficients[0] = float(b0 / a0);
+  coefficients[1] = float(b1 / a0);
+  coefficients[2] = float(b2 / a0);
+  coefficients[3] = float(a1 / a0);
+  coefficients[4] = float(a2 / a0);
+}
+
+//==============================================================================
+void
+MultiBandFilter::prepare(double newSampleRate)
+{
+  sampleRate = newSampleRate;
+  needsRedesign = true;
+  reset();
+}
+
+void
+MultiBandFilter::reset()
+{
+  for (auto& channelStates : states) {
+    channelStates.fill({});
+  }
+}
+
+void
+MultiBandFilter::update(const Settings& newSettings)
+{
+  for (int i = 0; i < MaxBands; ++i) {
+    if (needsRedesign || newSettings[i] != settings[i]) {
+      updateBand(i, newSettings[i]);
+    }
+  }
+
+  needsRedesign = false;
+}
+
+void
+MultiBandFilter::updateBand(int index, const BandSettings& band)
+{
+  jassert(juce::isPositiveAndBelow(index, MaxBands));
+
+  const auto activeChanged = band.bypassed != settings[index].bypassed;
+
+  if (activeChanged) {
+    // don't let a band that was switched off ring out when it comes back
+    for (auto& channelStates : states) {
+      channelStates[index] = {};
+    }
+  }
+
+  if (!band.bypassed) {
+    designBand(band, sampleRate, coefficients[index]);
+  }
+
+  settings[index] = band;
+
+  if (activeChanged) {
+    updateActiveBands();
+  }
+}
+
+void
+MultiBandFilter::getState(State& state) const
+{
+  state.settings = settings;
+  state.coefficients = coefficients;
+  state.states = states;
+}
+
+void
+MultiBandFilter::setState(const State& state)
+{
+  settings = state.settings;
+  coefficients = state.coefficients;
+  states = state.states;
+
+  needsRedesign = false;
+  updateActiveBands();
+}
+
+void
+MultiBandFilter::updateActiveBands()
+{
+  numActiveBands = 0;
+  for (int i = 0; i < MaxBands; ++i) {
+    if (!settings[i].bypassed) {
+      activeBands[numActiveBands++] = i;
+    }
+  }
+}
+
+void
+MultiBandFilter::process(juce::dsp::AudioBlock<float>& block)
+{
+  const auto numChannels =
+    juce::jmin((int)block.getNumChannels(), MaxChannels);
+  const auto numSamples = (int)block.getNumSamples();
+
+  for (int n = 0; n < numActiveBands; ++n) {
+    const auto band = activeBands[n];
+    const auto& c = coefficients[band];
+    const auto b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      auto* samples = block.getChannelPointer(ch);
+      auto z1 = states[ch][band].z1;
+      auto z2 = states[ch][band].z2;
+
+      // transposed direct form II
+      for (int i = 0; i < numSamples; ++i) {
+        auto in = samples[i];
+        auto out = b0 * in + z1;
+        z1 = b1 * in - a1 * out + z2;
+        z2 = b2 * in - a2 * out;
+        samples[i] = out;
+      }
+
+      states[ch][band].z1 = z1;
+      states[ch][band].z2 = z2;
+    }
+  }
+}
+
+double
+MultiBandFilter::getMagnitudeForFrequency(double freq) const
+{
+  const auto w = juce::MathConstants<double>::twoPi * freq / sampleRate;
+  const auto z1 = std::polar(1.0, -w);
+  const auto z2 = z1 * z1;
+
+  double mag = 1.0;
+  for (int n = 0; n < numActiveBands; ++n) {
+    const auto& c = coefficients[activeBands[n]];
+    auto numerator = double(c[0]) + double(c[1]) * z1 + double(c[2]) * z2;
+    auto denominator = 1.0 + double(c[3]) * z1 + double(c[4]) * z2;
+    mag *= std::abs(numerator / denominator);
+  }
+
+  return mag;
+}
+
+float
+MultiBandFilter::getStateMagnitude() const
+{
+  float magnitude = 0.f;
+  for (const auto& channelStates : states) {
+    for (int n = 0; n < numActiveBands; ++n) {
+      const auto& state = channelStates[activeBands[n]];
+      magnitude =
+        juce::jmax(magnitude, std::abs(state.z1), std::abs(state.z2));
+    }
+  }
+
+  return magnitude;
+}
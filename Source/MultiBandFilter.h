@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    MultiBandFilter.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+
+enum BandType
+{
+  BandType_Peak,
+  BandType_LowShelf,
+  BandType_HighShelf,
+  BandType_Notch,
+  BandType_LowCut,
+  BandType_HighCut,
+};
+
+struct BandSettings
+{
+  BandType type{ BandType::BandType_Peak };
+  float freq{ 1000.f }, gainInDecibels{ 0.f }, quality{ 1.f };
+
+  bool bypassed{ true };
+};
+
+bool
+operator==(const BandSettings& lhs, const BandSettings& rhs);
+bool
+operator!=(const BandSettings& lhs, const BandSettings& rhs);
+
+// b0, b1, b2, a1, a2 normalised by a0, the same layout juce uses for the raw
+// coefficients of a biquad
+using BiquadCoefficients = std::array<float, 5>;
+
+void
+designBand(const BandSettings& band,
+           double sampleRate,
+           BiquadCoefficients& coefficients);
+
+/* A band-count-agnostic bank of biquads.
+   All storage is preallocated for MaxBands, and only the bands that are not
+   bypassed are visited when processing.
+*/
+struct MultiBandFilter
+{
+  static constexpr int MaxBands = 24;
+  static constexpr int MaxChannels = 2;
+
+  using Settings = std::array<BandSettings, MaxBands>;
+
+  struct BiquadState
+  {
+    float z1{ 0 }, z2{ 0 };
+  };
+
+  // everything process() depends on, copyable without allocating
+  struct State
+  {
+    Settings settings;
+    std::array<BiquadCoefficients, MaxBands> coefficients;
+    std::array<std::array<BiquadState, MaxBands>, MaxChannels> states;
+  };
+
+  void getState(State& state) const;
+  void setState(const State& state);
+
+  void prepare(double sampleRate);
+  void reset();
+
+  // redesigns the bands whose settings changed since the last call
+  void update(const Settings& newSettings);
+
+  // redesigns a single band, whether or not it changed
+  void updateBand(int index, const BandSettings& band);
+
+  void process(juce::dsp::AudioBlock<float>& block);
+
+  double getMagnitudeForFrequency(double freq) const;
+
+  // the largest z1 or z2 of the active bands, i.e. how much they are still
+  // ringing
+  float getStateMagnitude() const;
+
+  int getNumActiveBands() const { return numActiveBands; }
+
+private:
+  double sampleRate = 44100.0;
+  bool needsRedesign = true;
+
+  Settings settings;
+  std::array<BiquadCoefficients, MaxBands> coefficients;
+  std::array<std::array<BiquadState, MaxBands>, MaxChannels> states;
+
+  std::array<int, MaxBands> activeBands;
+  int numActiveBands = 0;
+
+  void updateActiveBands();
+};
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+
+void
+OfflineRenderer::Chain::prepare(const OfflineRenderSettings& settings)
+{
+  juce::dsp::ProcessSpec spec;
+  spec.maximumBlockSize = blockSize;
+  spec.numChannels = 1;
+  spec.sampleRate = settings.sampleRate;
+
+  leftChain.prepare(spec);
+  rightChain.prepare(spec);
+  bandFilter.prepare(settings.sampleRate);
+
+  MonoChain* chains[] = { &leftChain, &rightChain };
+  for (int ch = 0; ch < 2; ++ch) {
+    auto& chain = *chains[ch];
+    const auto& cs = settings.chainSettings[ch];
+
+    chain.setBypassed<ChainPositions::LowCut>(cs.lowCutBypassed);
+    chain.setBypassed<ChainPositions::Peak>(cs.peakBypassed);
+    chain.setBypassed<ChainPositions::HighCut>(cs.highCutBypassed);
+
+    updateCutFilter(chain.get<ChainPositions::LowCut>(),
+                    false,
+                    cs.lowCutFreq,
+                    settings.sampleRate,
+                    cs.lowCutSlope);
+    designPeakFilter(
+      chain.get<ChainPositions::Peak>(), cs, settings.sampleRate);
+    updateCutFilter(chain.get<ChainPositions::HighCut>(),
+                    true,
+                    cs.highCutFreq,
+                    settings.sampleRate,
+                    cs.highCutSlope);
+  }
+
+  // the extra bands are shared, as they are in the processor
+  bandFilter.update(settings.chainSettings[0].bands);
+}
+
+void
+OfflineRenderer::Chain::process(juce::dsp::AudioBlock<float>& block,
+                                bool midSide)
+{
+  processStereoChains(leftChain, rightChain, bandFilter, block, midSide);
+}
+
+int
+OfflineRenderer::getWarmUpSamples(const OfflineRenderSettings& settings)
+{
+  const auto& cs = settings.chainSettings;
+  auto seconds = juce::jmax(getTailLengthSeconds(cs[0], settings.decayGain),
+                            getTailLengthSeconds(cs[1], settings.decayGain));
+
+  return (int)std::ceil(seconds * settings.sampleRate);
+}
+
+void
+OfflineRenderer::render(const OfflineRenderSettings& settings,
+                        const juce::AudioBuffer<float>& input,
+                        juce::AudioBuffer<float>& output,
+                        juce::ThreadPool& pool)
+{
+  jassert(input.getNumChannels() == 2);
+
+  const auto numSamples = input.getNumSamples();
+  output.setSize(2, numSamples, false, false, true);
+
+  if (numSamples == 0)
+    return;
+
+  // chunks much shorter than the warm-up would spend most of their time
+  // warming up
+  const auto warmUpSamples = getWarmUpSamples(settings);
+  const auto minChunk = juce::jmax(settings.minChunkSamples, warmUpSamples * 4);
+  const auto numChunks = juce::jlimit(
+    1, juce::jmax(1, pool.getNumThreads() * 2), numSamples / minChunk);
+  const auto chunkSize = (numSamples + numChunks - 1) / numChunks;
+
+  std::atomic<int> remaining{ numChunks };
+  juce::WaitableEvent finished;
+
+  for (int chunk = 0; chunk < numChunks; ++chunk) {
+    auto start = chunk * chunkSize;
+    auto end = juce::jmin(start + chunkSize, numSamples);
+
+    pool.addJob([&, start, end] {
+      renderChunk(settings, input, output, start, end, warmUpSamples);
+
+      if (--remaining == 0)
+        finished.signal();
+
+      return juce::ThreadPoolJob::jobHasFinished;
+    });
+  }
+
+  finished.wait();
+}
+
+void
+OfflineRenderer::renderChunk(const OfflineRenderSettings& settings,
+                             const juce::AudioBuffer<float>& input,
+                             juce::AudioBuffer<float>& output,
+                             int start,
+                             int end,
+                             int warmUpSamples)
+{
+  Chain chain;
+  chain.prepare(settings);
+
+  // the warm-up's output is thrown away, only the filter states are kept.
+  // the first chunk starts from silence, as a sequential render does
+  juce::AudioBuffer<float> scratch(2, blockSize);
+  for (int pos = juce::jmax(0, start - warmUpSamples); pos < start;) {
+    auto num = juce::jmin(blockSize, start - pos);
+    for (int ch = 0; ch < 2; ++ch) {
+      scratch.copyFrom(ch, 0, input, ch, pos, num);
+    }
+
+    juce::dsp::AudioBlock<float> block(scratch);
+    auto subBlock = block.getSubBlock(0, (size_t)num);
+    chain.process(subBlock, settings.midSide);
+    pos += num;
+  }
+
+  for (int ch = 0; ch < 2; ++ch) {
+    output.copyFrom(ch, start, input, ch, start, end - start);
+  }
+
+  juce::dsp::AudioBlock<float> outputBlock(output);
+  for (int pos = start; pos < end;) {
+    auto num = juce::jmin(blockSize, end - pos);
+    auto subBlock = outputBlock.getSubBlock((size_t)pos, (size_t)num);
+    chain.process(subBlock, settings.midSide);
+    pos += num;
+  }
+}
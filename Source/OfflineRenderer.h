@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "PluginProcessor.h"
+
+struct OfflineRenderSettings
+{
+  StereoChainSettings chainSettings;
+  bool midSide = false;
+  double sampleRate = 44100.0;
+
+  // how far the state carried over from before a chunk's warm-up may have
+  // decayed, -120 dB by default
+  double decayGain = 1e-6;
+
+  // chunks shorter than this aren't worth a job of their own
+  int minChunkSamples = 1 << 16;
+};
+
+/* Renders a long stereo buffer with fixed settings, split into chunks that
+   are rendered in parallel.
+   Before its own samples, each chunk runs its filters over the input that
+   precedes it, for as long as the filters take to decay by decayGain. The
+   stitched output then matches a sequential render to within about
+   decayGain times the input's peak level.
+*/
+struct OfflineRenderer
+{
+  // 'output' is resized to match 'input'. blocks until every chunk is done
+  static void render(const OfflineRenderSettings& settings,
+                     const juce::AudioBuffer<float>& input,
+                     juce::AudioBuffer<float>& output,
+                     juce::ThreadPool& pool);
+
+  static int getWarmUpSamples(const OfflineRenderSettings& settings);
+
+private:
+  static constexpr int blockSize = 4096;
+
+  // one chunk's worth of filters, designed the way the processor designs them
+  struct Chain
+  {
+    void prepare(const OfflineRenderSettings& settings);
+    void process(juce::dsp::AudioBlock<float>& block, bool midSide);
+
+    MonoChain leftChain, rightChain;
+    MultiBandFilter bandFilter;
+  };
+
+  static void renderChunk(const OfflineRenderSettings& settings,
+                          const juce::AudioBuffer<float>& input,
+                          juce::AudioBuffer<float>& output,
+                          int start,
+                          int end,
+                          int warmUpSamples);
+};
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshot.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "ParameterSnapshot.h"
+
+ParameterSnapshot::ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts,
+                                     ChainParameterSet set)
+{
+  // sized up front, the listener callback may come from any thread
+  const auto numParameters = (size_t)apvts.processor.getParameters().size();
+  bitsByParameterIndex.assign(numParameters, 0);
+  parametersByIndex.assign(numParameters, nullptr);
+  values = std::make_unique<std::atomic<float>[]>(numParameters);
+
+  const auto& ids = getChainParameterIDs(set);
+  const auto lowCut = getFixedBandBit(ChainPositions::LowCut);
+  const auto peak = getFixedBandBit(ChainPositions::Peak);
+  const auto highCut = getFixedBandBit(ChainPositions::HighCut);
+
+  addParameter(apvts, ids.lowCutFreq, lowCut, fixedBands.lowCutFreq);
+  addParameter(apvts, ids.lowCutSlope, lowCut, fixedBands.lowCutSlope);
+  addParameter(apvts, ids.lowCutBypassed, lowCut, fixedBands.lowCutBypassed);
+  addParameter(apvts, ids.peakFreq, peak, fixedBands.peakFreq);
+  addParameter(apvts, ids.peakGain, peak, fixedBands.peakGain);
+  addParameter(apvts, ids.peakQuality, peak, fixedBands.peakQuality);
+  addParameter(apvts, ids.peakBypassed, peak, fixedBands.peakBypassed);
+  addParameter(apvts, ids.highCutFreq, highCut, fixedBands.highCutFreq);
+  addParameter(apvts, ids.highCutSlope, highCut, fixedBands.highCutSlope);
+  addParameter(apvts, ids.highCutBypassed, highCut, fixedBands.highCutBypassed);
+
+  const auto& bandIDs = getBandParameterIDs();
+  for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+    const auto bit = getBandBit(i);
+    addParameter(apvts, bandIDs[i].type, bit, bands[i].type);
+    addParameter(apvts, bandIDs[i].freq, bit, bands[i].freq);
+    addParameter(apvts, bandIDs[i].gain, bit, bands[i].gain);
+    addParameter(apvts, bandIDs[i].quality, bit, bands[i].quality);
+    addParameter(apvts, bandIDs[i].bypassed, bit, bands[i].bypassed);
+  }
+
+  // every band starts out pending, so this fills in the first version
+  publish();
+}
+
+ParameterSnapshot::~ParameterSnapshot()
+{
+  for (auto* parameter : listenedTo)
+    parameter->removeListener(this);
+}
+
+void
+ParameterSnapshot::addParameter(juce::AudioProcessorValueTreeState& apvts,
+                                const juce::String& id,
+                                DirtyMask bit,
+                                Value& value)
+{
+  auto* parameter = apvts.getParameter(id);
+  jassert(parameter != nullptr);
+
+  auto index = (size_t)parameter->getParameterIndex();
+  jassert(index < bitsByParameterIndex.size());
+  bitsByParameterIndex[index] |= bit;
+  parametersByIndex[index] = parameter;
+
+  values[index].store(parameter->convertFrom0to1(parameter->getValue()));
+  value = &values[index];
+
+  parameter->addListener(this);
+  listenedTo.add(parameter);
+}
+
+void
+ParameterSnapshot::parameterValueChanged(int parameterIndex, float newValue)
+{
+  if (!juce::isPositiveAndBelow(parameterIndex,
+                                (int)parametersByIndex.size()))
+    return;
+
+  auto* parameter = parametersByIndex[(size_t)parameterIndex];
+  if (parameter == nullptr)
+    return;
+
+  // the value goes in before the bit is set, so a publish that sees the bit
+  // also sees the value
+  values[(size_t)parameterIndex].store(parameter->convertFrom0to1(newValue));
+  pendingChanges.fetch_or(bitsByParameterIndex[(size_t)parameterIndex]);
+}
+
+bool
+ParameterSnapshot::publish()
+{
+  if (pendingChanges.load() == 0)
+    return false;
+
+  const juce::SpinLock::ScopedTryLockType lock(publishLock);
+  if (!lock.isLocked())
+    return false;
+
+  // anything that changes from here on is left for the next publish
+  const auto changes = pendingChanges.exchange(0);
+  if (changes == 0)
+    return false;
+
+  readChangedBands(changes);
+
+  std::array<juce::uint32, NumWords> copy;
+  std::memcpy(copy.data(), &latest, sizeof(ChainSettings));
+
+  const auto oldSequence = sequence.load(std::memory_order_relaxed);
+
+  sequence.store(oldSequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (size_t i = 0; i < NumWords; ++i)
+    words[i].store(copy[i], std::memory_order_relaxed);
+
+  sequence.store(oldSequence + 2, std::memory_order_release);
+  return true;
+}
+
+void
+ParameterSnapshot::readChangedBands(DirtyMask changes)
+{
+  if ((changes & getFixedBandBit(ChainPositions::LowCut)) != 0) {
+    latest.lowCutFreq = fixedBands.lowCutFreq->load();
+    latest.lowCutSlope = static_cast<Slope>(fixedBands.lowCutSlope->load());
+    latest.lowCutBypassed = fixedBands.lowCutBypassed->load() > 0.5f;
+  }
+
+  if ((changes & getFixedBandBit(ChainPositions::Peak)) != 0) {
+    latest.peakFreq = fixedBands.peakFreq->load();
+    latest.peakGainInDecibles = fixedBands.peakGain->load();
+    latest.peakQuality = fixedBands.peakQuality->load();
+    latest.peakBypassed = fixedBands.peakBypassed->load() > 0.5f;
+  }
+
+  if ((changes & getFixedBandBit(ChainPositions::HighCut)) != 0) {
+    latest.highCutFreq = fixedBands.highCutFreq->load();
+    latest.highCutSlope = static_cast<Slope>(fixedBands.highCutSlope->load());
+    latest.highCutBypassed = fixedBands.highCutBypassed->load() > 0.5f;
+  }
+
+  for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+    if ((changes & getBandBit(i)) == 0)
+      continue;
+
+    auto& band = latest.bands[i];
+    band.type = static_cast<BandType>(bands[i].type->load());
+    band.freq = bands[i].freq->load();
+    band.gainInDecibels = bands[i].gain->load();
+    band.quality = bands[i].quality->load();
+    band.bypassed = bands[i].bypassed->load() > 0.5f;
+  }
+}
+
+bool
+ParameterSnapshot::tryRead(ChainSettings& settings,
+                           juce::uint32& version) const
+{
+  const auto before = sequence.load(std::memory_order_acquire);
+  if ((before & 1) != 0)
+    return false;
+
+  std::array<juce::uint32, NumWords> copy;
+  for (size_t i = 0; i < NumWords; ++i)
+    copy[i] = words[i].load(std::memory_order_relaxed);
+
+  // the copy only counts if no publish started while it was being taken
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (sequence.load(std::memory_order_relaxed) != before)
+    return false;
+
+  std::memcpy(&settings, copy.data(), sizeof(ChainSettings));
+  version = before / 2;
+  return true;
+}
+
+juce::uint32
+ParameterSnapshot::read(ChainSettings& settings) const
+{
+  juce::uint32 version = 0;
+  while (!tryRead(settings, version))
+    juce::Thread::yield();
+
+  return version;
+}
@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshot.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "PluginProcessor.h"
+
+/* One parameter set's ChainSettings, published with a version number through a
+   seqlock so the audio thread, the editor and tools can all read a consistent
+   copy without locking, and check cheaply whether anything has changed.
+
+   The parameters are looked up once. A parameter change stores the new value
+   here, then sets a bit for its band, and publish() reads just the bands that
+   changed into a new version. The values are kept here rather than read from
+   the APVTS because the APVTS stores its copy from a listener of its own,
+   which may run after this one. Any thread may publish, but only one at a
+   time does, the others return straight away and leave the changes to it.
+*/
+struct ParameterSnapshot : private juce::AudioProcessorParameter::Listener
+{
+  // one bit per band, the fixed bands by ChainPositions then the extra bands,
+  // the same numbering the processor and the response curve use
+  using DirtyMask = juce::uint32;
+
+  static constexpr int NumFixedBands = 3;
+  static constexpr int NumBands = NumFixedBands + MultiBandFilter::MaxBands;
+
+  static constexpr DirtyMask getFixedBandBit(ChainPositions position)
+  {
+    return DirtyMask(1) << position;
+  }
+
+  static constexpr DirtyMask getBandBit(int band)
+  {
+    return DirtyMask(1) << (NumFixedBands + band);
+  }
+
+  static constexpr DirtyMask allBands = (DirtyMask(1) << NumBands) - 1;
+
+  ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts,
+                    ChainParameterSet set);
+  ~ParameterSnapshot() override;
+
+  // publishes a new version if any parameter changed since the last one,
+  // returns true if it did. costs one atomic load when nothing changed
+  bool publish();
+
+  juce::uint32 getVersion() const { return sequence.load() / 2; }
+  bool hasChangedSince(juce::uint32 version) const
+  {
+    return getVersion() != version;
+  }
+
+  // copies the newest settings and returns their version, retrying while a
+  // publish is in progress
+  juce::uint32 read(ChainSettings& settings) const;
+
+  // a single attempt, for the audio thread. false if a publish was in
+  // progress, in which case 'settings' and 'version' are left alone
+  bool tryRead(ChainSettings& settings, juce::uint32& version) const;
+
+private:
+  // points into 'values'
+  using Value = const std::atomic<float>*;
+
+  struct FixedBandParameters
+  {
+    Value lowCutFreq, lowCutSlope, lowCutBypassed;
+    Value peakFreq, peakGain, peakQuality, peakBypassed;
+    Value highCutFreq, highCutSlope, highCutBypassed;
+  };
+
+  struct BandParameters
+  {
+    Value type, freq, gain, quality, bypassed;
+  };
+
+  juce::Array<juce::AudioProcessorParameter*> listenedTo;
+  FixedBandParameters fixedBands;
+  std::array<BandParameters, MultiBandFilter::MaxBands> bands;
+
+  // indexed by the processor's parameter index. the parameters not in this
+  // set have no bits and a null parameter
+  std::vector<DirtyMask> bitsByParameterIndex;
+  std::vector<juce::RangedAudioParameter*> parametersByIndex;
+  std::unique_ptr<std::atomic<float>[]> values;
+  std::atomic<DirtyMask> pendingChanges{ allBands };
+
+  // only touched by the thread holding publishLock
+  juce::SpinLock publishLock;
+  ChainSettings latest;
+
+  // the settings as words, so readers and the publisher never race on plain
+  // memory. odd sequence numbers mean a publish is in progress
+  static constexpr size_t NumWords =
+    sizeof(ChainSettings) / sizeof(juce::uint32);
+  static_assert(sizeof(ChainSettings) % sizeof(juce::uint32) == 0 &&
+                  std::is_trivially_copyable_v<ChainSettings>,
+                "ChainSettings has to copy word by word");
+
+  std::atomic<juce::uint32> sequence{ 0 };
+  std::array<std::atomic<juce::uint32>, NumWords> words;
+
+  void addParameter(juce::AudioProcessorValueTreeState& apvts,
+                    const juce::String& id,
+                    DirtyMask bit,
+                    Value& value);
+
+  void readChangedBands(DirtyMask changes);
+
+  void parameterValueChanged(int parameterIndex, float newValue) override;
+  void parameterGestureChanged(int, bool) override {}
+};
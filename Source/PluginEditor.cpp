@@ -8,8 +8,396 @@
 
 #include "PluginEditor.h"
 
+#include "ParameterSnapshot.h"
 #include "PluginProcessor.h"
 
+//==============================================================================
+SpectrumAnalyzer::SpectrumAnalyzer(SimpleEqAudioProcessor& p)
+{
+  taps[AnalyzerTap_PostLeft].fifo = &p.leftChannelFifo;
+  taps[AnalyzerTap_PostRight].fifo = &p.rightChannelFifo;
+  taps[AnalyzerTap_PreLeft].fifo = &p.preLeftChannelFifo;
+  taps[AnalyzerTap_PreRight].fifo = &p.preRightChannelFifo;
+}
+
+void
+SpectrumAnalyzer::setTapEnabled(AnalyzerTap tap, bool enabled)
+{
+  auto& t = taps[tap];
+  if (t.enabled == enabled)
+    return;
+
+  t.enabled = enabled;
+
+  // a tap that comes back starts from silence rather than stale audio
+  t.history.clear();
+  std::fill(t.spectrum.begin(), t.spectrum.end(), negativeInfinity);
+}
+
+void
+SpectrumAnalyzer::prepare()
+{
+  const auto fftSize = getFFTSize();
+
+  for (auto& tap : taps) {
+    tap.history.setSize(1, fftSize);
+    tap.history.clear();
+    tap.spectrum.assign((size_t)getNumBins(), negativeInfinity);
+  }
+
+  workspace.setSize(NumAnalyzerTaps, fftSize * 2);
+}
+
+void
+SpectrumAnalyzer::pullAudio(Tap& tap)
+{
+  auto* history = tap.history.getWritePointer(0);
+  const auto historySize = tap.history.getNumSamples();
+
+  while (tap.fifo->getNumCompleteBuffersAvailable() > 0) {
+    if (tap.fifo->getAudioBuffer(incoming)) {
+      // a hop longer than the history only keeps its newest samples
+      auto size = juce::jmin(incoming.getNumSamples(), historySize);
+      auto* newest =
+        incoming.getReadPointer(0, incoming.getNumSamples() - size);
+
+      juce::FloatVectorOperations::copy(
+        history, history + size, historySize - size);
+
+      juce::FloatVectorOperations::copy(
+        history + historySize - size, newest, size);
+
+      tap.hasNewAudio = true;
+    }
+  }
+}
+
+bool
+SpectrumAnalyzer::process()
+{
+  if (workspace.getNumSamples() == 0)
+    prepare();
+
+  bool anyNewAudio = false;
+  for (auto& tap : taps) {
+    if (tap.enabled) {
+      pullAudio(tap);
+      anyNewAudio = anyNewAudio || tap.hasNewAudio;
+    }
+  }
+
+  if (!anyNewAudio)
+    return false;
+
+  const auto& fft = sharedResources->getFFT(order);
+  const auto& window = sharedResources->getWindow(order);
+
+  for (int i = 0; i < NumAnalyzerTaps; ++i) {
+    auto& tap = taps[i];
+    if (!tap.hasNewAudio)
+      continue;
+
+    tap.hasNewAudio = false;
+
+    computeSpectrum(tap.history.getReadPointer(0),
+                    order,
+                    fft,
+                    window,
+                    workspace.getWritePointer(i),
+                    tap.spectrum.data(),
+                    negativeInfinity);
+  }
+
+  return true;
+}
+
+size_t
+SpectrumAnalyzer::getMemoryBytes() const
+{
+  auto bytes = ::getMemoryBytes(workspace) + ::getMemoryBytes(incoming);
+  for (const auto& tap : taps)
+    bytes += ::getMemoryBytes(tap.history) + ::getMemoryBytes(tap.spectrum);
+
+  return bytes;
+}
+
+void
+SpectrumAnalyzer::setOrder(FFTOrder newOrder)
+{
+  if (newOrder == order)
+    return;
+
+  order = newOrder;
+  prepare();
+}
+
+//==============================================================================
+AnalyzerQualityGovernor::AnalyzerQualityGovernor()
+{
+  setBounds(15, 60, order1024, order2048);
+}
+
+void
+AnalyzerQualityGovernor::setBounds(int minFrameRateHz,
+                                   int maxFrameRateHz,
+                                   FFTOrder minOrder,
+                                   FFTOrder maxOrder)
+{
+  jassert(0 < minFrameRateHz && minFrameRateHz <= maxFrameRateHz);
+  jassert(minOrder <= maxOrder);
+
+  levels.clear();
+  Level level{ maxFrameRateHz, maxOrder };
+  levels.push_back(level);
+
+  for (bool halveRate = true;; halveRate = !halveRate) {
+    auto canHalveRate = level.frameRateHz / 2 >= minFrameRateHz;
+    auto canHalveOrder = level.order > minOrder;
+
+    if (!canHalveRate && !canHalveOrder)
+      break;
+
+    if ((halveRate && canHalveRate) || !canHalveOrder) {
+      level.frameRateHz /= 2;
+    } else {
+      level.order = static_cast<FFTOrder>(level.order - 1);
+    }
+
+    levels.push_back(level);
+  }
+
+  changeLevel(0);
+}
+
+bool
+AnalyzerQualityGovernor::update(double processingSeconds,
+                                double intervalSeconds)
+{
+  const auto period = 1.0 / getLevel().frameRateHz;
+
+  // the analyzer's own share of a core, and how late the timer fired, which
+  // rises when the message thread or the machine is overloaded
+  auto load = processingSeconds / period;
+  auto lateness = juce::jmax(0.0, intervalSeconds / period - 1.0);
+
+  smoothedLoad += 0.1 * (load - smoothedLoad);
+  smoothedLateness += 0.1 * (lateness - smoothedLateness);
+  ++framesAtLevel;
+
+  // give a change half a second to settle before stepping down again, and
+  // wait for three seconds of headroom before stepping back up
+  const auto rate = getLevel().frameRateHz;
+  auto overBudget = smoothedLoad > budget || smoothedLateness > 0.5;
+  auto hasHeadroom = smoothedLoad < budget * 0.25 && smoothedLateness < 0.1;
+
+  if (overBudget && framesAtLevel > rate / 2 &&
+      current + 1 < (int)levels.size()) {
+    changeLevel(current + 1);
+    return true;
+  }
+
+  if (hasHeadroom && framesAtLevel > rate * 3 && current > 0) {
+    changeLevel(current - 1);
+    return true;
+  }
+
+  return false;
+}
+
+void
+AnalyzerQualityGovernor::changeLevel(int newLevel)
+{
+  current = newLevel;
+  framesAtLevel = 0;
+  smoothedLoad = smoothedLateness = 0;
+}
+
+//==============================================================================
+void
+SpectrumPixelMap::prepare(int numBins, float newBinWidth, int newWidth)
+{
+  binWidth = newBinWidth;
+  width = newWidth;
+
+  // bin 0 is DC, which has no place on a log axis, so it sits on the edge
+  pixels.assign((size_t)numBins, 0);
+  for (int bin = 1; bin < numBins; ++bin) {
+    auto normalizedX = juce::mapFromLog10(bin * binWidth, 20.f, 20000.f);
+    pixels[(size_t)bin] = (int)std::floor(float(width) * normalizedX);
+  }
+}
+
+bool
+SpectrumPixelMap::isPreparedFor(int numBins,
+                                float newBinWidth,
+                                int newWidth) const
+{
+  return getNumBins() == numBins && binWidth == newBinWidth &&
+         width == newWidth;
+}
+
+juce::Path
+makeSpectrumPath(const float* decibels,
+                 const SpectrumPixelMap& pixelMap,
+                 juce::Rectangle<float> bounds,
+                 float minDb,
+                 float maxDb)
+{
+  juce::Path p;
+  p.preallocateSpace(3 * (int)bounds.getWidth());
+
+  auto map = [&](float v) {
+    return juce::jmap(juce::jlimit(minDb, maxDb, v),
+                      minDb,
+                      maxDb,
+                      bounds.getBottom(),
+                      bounds.getY());
+  };
+
+  p.startNewSubPath(bounds.getX(), map(decibels[0]));
+
+  // you can draw line-to's every 'pathResolution' bins
+  const int pathResolution = 2;
+  const auto numBins = pixelMap.getNumBins();
+  for (int binNum = 1; binNum < numBins; binNum += pathResolution) {
+    auto y = map(decibels[binNum]);
+
+    if (!std::isnan(y) && !std::isinf(y)) {
+      auto binX = bounds.getX() + float(pixelMap.getPixel(binNum));
+      p.lineTo(binX, y);
+    }
+  }
+
+  return p;
+}
+
+//==============================================================================
+WaterfallImage::WaterfallImage()
+{
+  // quiet bins stay transparent so the grid shows through
+  juce::ColourGradient gradient(juce::Colours::black,
+                                0.f,
+                                0.f,
+                                juce::Colour(255u, 240u, 160u),
+                                1.f,
+                                0.f,
+                                false);
+  gradient.addColour(0.35, juce::Colour(60u, 30u, 120u));
+  gradient.addColour(0.7, juce::Colour(255u, 31u, 172u));
+
+  for (int i = 0; i < (int)palette.size(); ++i) {
+    auto position = double(i) / double(palette.size() - 1);
+    palette[(size_t)i] =
+      gradient.getColourAtPosition(position).withAlpha(float(position));
+  }
+}
+
+void
+WaterfallImage::setSize(int width, int height)
+{
+  if (width <= 0 || height <= 0) {
+    image = {};
+    return;
+  }
+
+  if (image.getWidth() == width && image.getHeight() == height)
+    return;
+
+  image = juce::Image(juce::Image::ARGB, width, height, true);
+  rowLevels.resize((size_t)width);
+  newestRow = 0;
+}
+
+void
+WaterfallImage::clear()
+{
+  if (image.isValid())
+    image.clear(image.getBounds());
+}
+
+void
+WaterfallImage::addFrame(const float* decibels,
+                         const SpectrumPixelMap& pixelMap,
+                         float minDb,
+                         float maxDb)
+{
+  if (!image.isValid())
+    return;
+
+  const auto width = image.getWidth();
+  jassert(pixelMap.getWidth() == width);
+
+  // the loudest bin in each column. below a few hundred Hz a bin is wider
+  // than a column, so the columns in between take the bin to their left
+  const auto unset = std::numeric_limits<float>::lowest();
+  std::fill(rowLevels.begin(), rowLevels.end(), unset);
+
+  for (int bin = 0; bin < pixelMap.getNumBins(); ++bin) {
+    auto x = pixelMap.getPixel(bin);
+    if (juce::isPositiveAndBelow(x, width))
+      rowLevels[(size_t)x] = juce::jmax(rowLevels[(size_t)x], decibels[bin]);
+  }
+
+  newestRow = (newestRow + image.getHeight() - 1) % image.getHeight();
+
+  juce::Image::BitmapData row(
+    image, 0, newestRow, width, 1, juce::Image::BitmapData::writeOnly);
+
+  auto level = minDb;
+  const auto maxIndex = int(palette.size()) - 1;
+  for (int x = 0; x < width; ++x) {
+    if (rowLevels[(size_t)x] != unset)
+      level = rowLevels[(size_t)x];
+
+    auto index = juce::roundToInt(
+      juce::jmap(juce::jlimit(minDb, maxDb, level), minDb, maxDb, 0.f, 1.f) *
+      float(maxIndex));
+    row.setPixelColour(x, 0, palette[(size_t)index]);
+  }
+}
+
+void
+WaterfallImage::draw(juce::Graphics& g, juce::Rectangle<int> area) const
+{
+  if (!image.isValid())
+    return;
+
+  const auto width = image.getWidth();
+  const auto height = image.getHeight();
+  const auto newerRows = height - newestRow;
+
+  // newest row to the bottom of the image, then the top of the image under it
+  g.drawImage(image,
+              area.getX(),
+              area.getY(),
+              width,
+              newerRows,
+              0,
+              newestRow,
+              width,
+              newerRows);
+
+  if (newestRow > 0) {
+    g.drawImage(image,
+                area.getX(),
+                area.getY() + newerRows,
+                width,
+                newestRow,
+                0,
+                0,
+                width,
+                newestRow);
+  }
+}
+
+size_t
+WaterfallImage::getMemoryBytes() const
+{
+  auto pixels = size_t(image.getWidth()) * image.getHeight();
+  return pixels * 4 + ::getMemoryBytes(rowLevels);
+}
+
+//==============================================================================
 void
 LookAndFeel::drawRotarySlider(juce::Graphics& g,
                               int x,
@@ -227,122 +615,239 @@ RotarySliderWithLabels::getDisplayString() const
 //==============================================================================
 ResponseCurveComponent::ResponseCurveComponent(SimpleEqAudioProcessor& p)
   : audioProcessor(p)
-  , leftPathProducer(audioProcessor.leftChannelFifo)
-  , rightPathProducer(audioProcessor.rightChannelFifo)
+  , analyzer(audioProcessor)
 {
-  const auto& params = audioProcessor.getParameters();
-  for (auto param : params) {
-    param->addListener(this);
-  }
+  stereoMode = audioProcessor.apvts.getRawParameterValue("Stereo Mode");
+  channelLink = audioProcessor.apvts.getRawParameterValue("Channel Link");
 
-  updateChain();
-  startTimerHz(60);
+  // with a compact memory budget the taps are only allocated now
+  audioProcessor.attachAnalyzer();
+
+  // the chain is designed on the first paint, so opening the editor doesn't
+  // wait for it
+  updateAnalyzerTaps();
+  startTimerHz(qualityGovernor.getLevel().frameRateHz);
 };
 
 ResponseCurveComponent::~ResponseCurveComponent()
 {
-  const auto& params = audioProcessor.getParameters();
-  for (auto param : params) {
-    param->removeListener(this);
-  }
+  audioProcessor.preAnalysisEnabled.store(false);
 };
 
 void
-ResponseCurveComponent::parameterValueChanged(int parameterIndex,
-                                              float newValue)
+ResponseCurveComponent::timerCallback()
 {
-  parametersChanged.set(true);
+  using Time = juce::Time;
+
+  const auto startTicks = Time::getHighResolutionTicks();
+
+  if (shouldShowFFTAnalysis && analyzer.process()) {
+    updateAnalyzerPaths();
+  }
+
+  if (shouldShowFFTAnalysis && lastTimerTicks != 0) {
+    auto processing = Time::highResolutionTicksToSeconds(
+      Time::getHighResolutionTicks() - startTicks);
+    auto interval =
+      Time::highResolutionTicksToSeconds(startTicks - lastTimerTicks);
+
+    if (qualityGovernor.update(processing, interval)) {
+      const auto& level = qualityGovernor.getLevel();
+      analyzer.setOrder(level.order);
+      startTimerHz(level.frameRateHz);
+    }
+  }
+  lastTimerTicks = startTicks;
+
+  // signal a repaint, which picks up any parameter changes
+  repaint();
 }
 
 void
-PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
+ResponseCurveComponent::toggleAnalysisEnablement(bool enabled)
 {
-  juce::AudioBuffer<float> tempIncomingBuffer;
+  shouldShowFFTAnalysis = enabled;
+  updateAnalyzerTaps();
+}
 
-  while (leftChannelFifo->getNumCompleteBuffersAvailable() > 0) {
-    if (leftChannelFifo->getAudioBuffer(tempIncomingBuffer)) {
-      auto size = tempIncomingBuffer.getNumSamples();
+void
+ResponseCurveComponent::setAnalyzerView(AnalyzerView newView)
+{
+  if (newView == AnalyzerView_Waterfall && analyzerView != newView)
+    waterfall.clear();
 
-      juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, 0),
-                                        monoBuffer.getReadPointer(0, size),
-                                        monoBuffer.getNumSamples() - size);
+  analyzerView = newView;
+  updateAnalyzerTaps();
+}
 
-      juce::FloatVectorOperations::copy(
-        monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-        tempIncomingBuffer.getReadPointer(0, 0),
-        size);
+void
+ResponseCurveComponent::setAnalyzerQualityBounds(int minFrameRateHz,
+                                                 int maxFrameRateHz,
+                                                 FFTOrder minOrder,
+                                                 FFTOrder maxOrder)
+{
+  qualityGovernor.setBounds(minFrameRateHz, maxFrameRateHz, minOrder, maxOrder);
+
+  const auto& level = qualityGovernor.getLevel();
+  analyzer.setOrder(level.order);
+  startTimerHz(level.frameRateHz);
+}
+
+void
+ResponseCurveComponent::updateAnalyzerTaps()
+{
+  // the input is only tapped and transformed while it's on screen
+  const auto showInput =
+    shouldShowFFTAnalysis && (analyzerView == AnalyzerView_InputAndOutput ||
+                              analyzerView == AnalyzerView_Difference);
+
+  analyzer.setTapEnabled(AnalyzerTap_PostLeft, shouldShowFFTAnalysis);
+  analyzer.setTapEnabled(AnalyzerTap_PostRight, shouldShowFFTAnalysis);
+  analyzer.setTapEnabled(AnalyzerTap_PreLeft, showInput);
+  analyzer.setTapEnabled(AnalyzerTap_PreRight, showInput);
 
-      leftChannelFFTDataGenerator.produceFFTDataForRendering(monoBuffer, -48.f);
+  audioProcessor.preAnalysisEnabled.store(showInput);
+}
+
+void
+ResponseCurveComponent::updateAnalyzerPaths()
+{
+  const auto bounds = getAnalysisArea().toFloat().withZeroOrigin();
+  const auto numBins = analyzer.getNumBins();
+  const auto binWidth =
+    float(audioProcessor.getSampleRate() / double(analyzer.getFFTSize()));
+  const auto width = (int)bounds.getWidth();
+  const auto minDb = SpectrumAnalyzer::negativeInfinity;
+
+  if (!pixelMap.isPreparedFor(numBins, binWidth, width))
+    pixelMap.prepare(numBins, binWidth, width);
+
+  for (int i = 0; i < NumAnalyzerTaps; ++i) {
+    auto tap = static_cast<AnalyzerTap>(i);
+    if (analyzer.isTapEnabled(tap)) {
+      tapPaths[i] = makeSpectrumPath(
+        analyzer.getSpectrum(tap), pixelMap, bounds, minDb, 0.f);
     }
   }
 
-  /*
-  if there are FFT data buffers to pull
-      if we can pull a buffer
-        generate a path
-  */
-  const auto fftSize = leftChannelFFTDataGenerator.getFFTSize();
-  const auto binWidth = sampleRate / double(fftSize);
+  if (analyzerView == AnalyzerView_Waterfall) {
+    const auto* left = analyzer.getSpectrum(AnalyzerTap_PostLeft);
+    const auto* right = analyzer.getSpectrum(AnalyzerTap_PostRight);
+
+    waterfallFrame.resize((size_t)numBins);
+    juce::FloatVectorOperations::add(
+      waterfallFrame.data(), left, right, numBins);
+    juce::FloatVectorOperations::multiply(waterfallFrame.data(), 0.5f, numBins);
 
-  while (leftChannelFFTDataGenerator.getNumAvailbleFFTDataBlocks() > 0) {
-    std::vector<float> fftData;
-    if (leftChannelFFTDataGenerator.getFFTData(fftData)) {
-      pathProducer.generatePath(fftData, fftBounds, fftSize, binWidth, -48.f);
+    waterfall.addFrame(waterfallFrame.data(), pixelMap, minDb, 0.f);
+  }
+
+  if (analyzerView == AnalyzerView_Difference) {
+    // what the EQ did to the signal, on the same scale as the response curve
+    difference.resize((size_t)numBins);
+    for (int bin = 0; bin < numBins; ++bin) {
+      auto left = analyzer.getSpectrum(AnalyzerTap_PostLeft)[bin] -
+                  analyzer.getSpectrum(AnalyzerTap_PreLeft)[bin];
+      auto right = analyzer.getSpectrum(AnalyzerTap_PostRight)[bin] -
+                   analyzer.getSpectrum(AnalyzerTap_PreRight)[bin];
+      difference[bin] = 0.5f * (left + right);
     }
+
+    differencePath =
+      makeSpectrumPath(difference.data(), pixelMap, bounds, -24.f, 24.f);
   }
+}
 
-  /*
-  while there are paths that can be pulled
-    pull as many as we can
-      display the most recent path
-  */
-  while (pathProducer.getNumPathsAvailable()) {
-    pathProducer.getPath(leftChannelFFTPath);
+size_t
+getMemoryBytes(const juce::Path& path)
+{
+  using Iterator = juce::Path::Iterator;
+
+  // each element is stored as a marker followed by its points
+  size_t numFloats = 0;
+  Iterator it(path);
+  while (it.next()) {
+    switch (it.elementType) {
+      case Iterator::cubicTo:
+        numFloats += 7;
+        break;
+      case Iterator::quadraticTo:
+        numFloats += 5;
+        break;
+      case Iterator::closePath:
+        numFloats += 1;
+        break;
+      default:
+        numFloats += 3;
+        break;
+    }
   }
+
+  return numFloats * sizeof(float);
 }
 
 void
-ResponseCurveComponent::timerCallback()
+ResponseCurveComponent::addMemoryFootprint(MemoryFootprint& footprint) const
 {
-  if (shouldShowFFTAnalysis) {
-    auto fftBounds = getAnalysisArea().toFloat();
-    auto sampleRate = audioProcessor.getSampleRate();
-    leftPathProducer.process(fftBounds, sampleRate);
-    rightPathProducer.process(fftBounds, sampleRate);
-  }
+  footprint.add("Editor analyzer", analyzer.getMemoryBytes());
 
-  if (parametersChanged.compareAndSetBool(false, true)) {
-    updateChain();
-  }
-  // signal a repaint
-  repaint();
+  auto pathBytes = getMemoryBytes(differencePath) + getMemoryBytes(difference) +
+                   getMemoryBytes(waterfallFrame);
+  for (const auto& path : tapPaths)
+    pathBytes += getMemoryBytes(path);
+  footprint.add("Editor analyzer paths", pathBytes);
+
+  footprint.add("Editor waterfall", waterfall.getMemoryBytes());
+  footprint.add("Editor response curve",
+                responseCurve.getMemoryBytes() +
+                  secondaryResponseCurve.getMemoryBytes());
+
+  juce::SharedResourcePointer<SharedFFTResources> fftResources;
+  footprint.add("FFT tables", fftResources->getMemoryBytes(), true);
 }
 
 void
 ResponseCurveComponent::updateChain()
 {
-  // update monochain
-  auto chainSettings = getChainSettings(audioProcessor.apvts);
+  auto& parameters = audioProcessor.getParameterSnapshot(MainParameters);
 
-  monoChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-  monoChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-  monoChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-  auto peakCoefficients =
-    makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-  updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients,
-                     peakCoefficients);
+  // nothing else publishes while the host isn't playing
+  parameters.publish();
 
-  auto lowCutCoefficients =
-    makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-  auto highCutCoefficients =
-    makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
+  if (!chainSettingsValid || parameters.hasChangedSince(chainSettingsVersion)) {
+    chainSettingsVersion = parameters.read(chainSettings);
+    chainSettingsValid = true;
+  }
+
+  auto set = getSecondaryParameterSet();
+  if (set != secondarySet) {
+    secondarySet = set;
+    secondaryChainSettingsValid = false;
+  }
+
+  if (secondarySet == MainParameters)
+    return;
+
+  auto& secondary = audioProcessor.getParameterSnapshot(secondarySet);
+  secondary.publish();
 
-  updateCutFilter(monoChain.get<ChainPositions::LowCut>(),
-                  lowCutCoefficients,
-                  chainSettings.lowCutSlope);
-  updateCutFilter(monoChain.get<ChainPositions::HighCut>(),
-                  highCutCoefficients,
-                  chainSettings.highCutSlope);
+  if (!secondaryChainSettingsValid ||
+      secondary.hasChangedSince(secondaryChainSettingsVersion)) {
+    secondaryChainSettingsVersion = secondary.read(secondaryChainSettings);
+    secondaryChainSettingsValid = true;
+  }
+
+  // the extra bands are shared, as they are in the processor
+  secondaryChainSettings.bands = chainSettings.bands;
+}
+
+ChainParameterSet
+ResponseCurveComponent::getSecondaryParameterSet() const
+{
+  if (stereoMode->load() > 0.5f)
+    return SideParameters;
+
+  return channelLink->load() < 0.5f ? RightParameters : MainParameters;
 }
 
 void
@@ -352,6 +857,14 @@ ResponseCurveComponent::paint(juce::Graphics& g)
   // solid colour)
   using namespace juce;
 
+  updateChain();
+
+  // the editor may have moved to a display with a different scale
+  if (Component::getApproximateScaleFactorForComponent(this) !=
+      backgroundScale) {
+    updateBackground();
+  }
+
   g.fillAll(Colours::black);
 
   g.drawImage(background, getLocalBounds().toFloat());
@@ -359,106 +872,161 @@ ResponseCurveComponent::paint(juce::Graphics& g)
   auto responseArea = getAnalysisArea();
   auto w = responseArea.getWidth();
 
-  auto& lowCut = monoChain.get<ChainPositions::LowCut>();
-  auto& peak = monoChain.get<ChainPositions::Peak>();
-  auto& highCut = monoChain.get<ChainPositions::HighCut>();
-
+  // one point per pixel, and only the bands that changed are evaluated again
   auto sampleRate = audioProcessor.getSampleRate();
+  if (!responseCurve.isPreparedFor(w, sampleRate)) {
+    std::vector<double> freqs(w);
+    for (int i = 0; i < w; i++) {
+      freqs[i] = mapToLog10(double(i) / double(w), 20.0, 20000.0);
+    }
+    responseCurve.prepare(freqs, sampleRate);
+  }
 
-  std::vector<double> mags;
-
-  mags.resize(w);
-
-  for (int i = 0; i < w; i++) {
-    double mag = 1.f;
-    auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
+  responseCurve.update(chainSettings);
+  const auto& response = responseCurve.getResponse();
 
-    if (!monoChain.isBypassed<ChainPositions::Peak>()) {
-      mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
+  if (secondarySet != MainParameters) {
+    if (!secondaryResponseCurve.isPreparedFor(w, sampleRate)) {
+      secondaryResponseCurve.prepare(responseCurve.getFrequencies(),
+                                     sampleRate);
     }
-    if (!monoChain.isBypassed<ChainPositions::LowCut>()) {
-      if (!lowCut.isBypassed<0>()) {
-        mag *= lowCut.get<0>().coefficients->getMagnitudeForFrequency(
-          freq, sampleRate);
-      }
-      if (!lowCut.isBypassed<1>()) {
-        mag *= lowCut.get<1>().coefficients->getMagnitudeForFrequency(
-          freq, sampleRate);
-      }
-      if (!lowCut.isBypassed<2>()) {
-        mag *= lowCut.get<2>().coefficients->getMagnitudeForFrequency(
-          freq, sampleRate);
-      }
-      if (!lowCut.isBypassed<3>()) {
-        mag *= lowCut.get<3>().coefficients->getMagnitudeForFrequency(
-          freq, sampleRate);
-      }
-    }
-    if (!monoChain.isBypassed<ChainPositions::HighCut>()) {
-      if (!highCut.isBypassed<0>()) {
-        mag *= highCut.get<0>().coefficients->getMagnitudeForFrequency(
-          freq, sampleRate);
-      }
-      if (!highCut.isBypassed<1>()) {
-        mag *= highCut.get<1>().coefficients->getMagnitudeForFrequency(
-          freq, sampleRate);
-      }
-      if (!highCut.isBypassed<2>()) {
-        mag *= highCut.get<2>().coefficients->getMagnitudeForFrequency(
-          freq, sampleRate);
-      }
-      if (!highCut.isBypassed<3>()) {
-        mag *= highCut.get<3>().coefficients->getMagnitudeForFrequency(
-          freq, sampleRate);
-      }
-    }
-    mags[i] = Decibels::gainToDecibels(mag);
+
+    secondaryResponseCurve.update(secondaryChainSettings);
   }
+  const auto& mags = response.magnitudeDecibels;
 
-  Path responseCurve;
+  if (mags.empty())
+    return;
 
   const double outputMin = responseArea.getBottom();
   const double outputMax = responseArea.getY();
-  auto map = [outputMin, outputMax](double input) {
-    return jmap(input, -24.0, 24.0, outputMin, outputMax);
+
+  auto makeCurve = [&](const std::vector<float>& values,
+                       double minValue,
+                       double maxValue) {
+    auto map = [=](double input) {
+      return jmap(input, minValue, maxValue, outputMin, outputMax);
+    };
+
+    Path curve;
+    curve.preallocateSpace(3 * (int)values.size());
+    curve.startNewSubPath(responseArea.getX(), map(values.front()));
+
+    for (size_t i = 1; i < values.size(); i++) {
+      curve.lineTo(responseArea.getX() + i, map(values[i]));
+    }
+    return curve;
   };
 
-  responseCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
+  auto magnitudeCurve = makeCurve(mags, -24.0, 24.0);
 
-  for (size_t i = 1; i < mags.size(); i++) {
-    responseCurve.lineTo(responseArea.getX() + i, map(mags[i]));
+  if (shouldShowFFTAnalysis && analyzerView == AnalyzerView_Waterfall) {
+    waterfall.draw(g, responseArea);
   }
 
   if (shouldShowFFTAnalysis) {
-    auto leftChannelFFTPath = leftPathProducer.getPath();
-    leftChannelFFTPath.applyTransform(
-      AffineTransform().translation(responseArea.getX(), responseArea.getY()));
-
-    g.setColour(Colour(255u, 31u, 172u));
-    g.strokePath(leftChannelFFTPath, PathStrokeType(1.f));
-
-    auto rightChannelFFTPath = rightPathProducer.getPath();
-    rightChannelFFTPath.applyTransform(
-      AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+    auto toResponseArea =
+      AffineTransform().translation(responseArea.getX(), responseArea.getY());
+
+    auto drawTap = [&](AnalyzerTap tap, Colour colour) {
+      auto path = tapPaths[tap];
+      path.applyTransform(toResponseArea);
+      g.setColour(colour);
+      g.strokePath(path, PathStrokeType(1.f));
+    };
+
+    if (analyzerView == AnalyzerView_Difference) {
+      auto path = differencePath;
+      path.applyTransform(toResponseArea);
+      g.setColour(Colour(255u, 31u, 172u));
+      g.strokePath(path, PathStrokeType(1.f));
+    } else {
+      if (analyzerView == AnalyzerView_InputAndOutput) {
+        drawTap(AnalyzerTap_PreLeft, Colour(255u, 31u, 172u).withAlpha(0.4f));
+        drawTap(AnalyzerTap_PreRight, Colour(160u, 130u, 212u).withAlpha(0.4f));
+      }
 
-    g.setColour(Colour(160u, 130u, 212u));
-    g.strokePath(rightChannelFFTPath, PathStrokeType(1.f));
+      drawTap(AnalyzerTap_PostLeft, Colour(255u, 31u, 172u));
+      drawTap(AnalyzerTap_PostRight, Colour(160u, 130u, 212u));
+    }
   }
 
   g.setColour(Colour(58u, 245u, 245u));
   g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
 
+  if (overlay == ResponseOverlay_Phase) {
+    g.setColour(Colour(120u, 200u, 120u));
+    g.strokePath(makeCurve(response.phaseRadians,
+                           -MathConstants<double>::pi,
+                           MathConstants<double>::pi),
+                 PathStrokeType(1.f));
+  } else if (overlay == ResponseOverlay_GroupDelay) {
+    // scaled to the largest delay on screen, at least a millisecond
+    const auto& delays = response.groupDelaySeconds;
+    auto range = FloatVectorOperations::findMinAndMax(delays.data(),
+                                                      (int)delays.size());
+    auto maxDelay = jmax(0.001, double(range.getEnd()));
+
+    g.setColour(Colour(120u, 200u, 120u));
+    g.strokePath(makeCurve(delays, 0.0, maxDelay), PathStrokeType(1.f));
+
+    String str;
+    str << String(maxDelay * 1000.0, 1) << " ms";
+    g.setFont(10);
+    g.drawText(str,
+               responseArea.removeFromTop(12).removeFromRight(60),
+               Justification::centredRight,
+               false);
+  }
+
+  if (secondarySet != MainParameters) {
+    const auto& secondaryMags =
+      secondaryResponseCurve.getResponse().magnitudeDecibels;
+    const auto secondaryColour = Colour(255u, 200u, 60u);
+
+    g.setColour(secondaryColour);
+    g.strokePath(makeCurve(secondaryMags, -24.0, 24.0), PathStrokeType(1.5f));
+
+    g.setFont(10);
+    g.drawText(secondarySet == SideParameters ? "Side" : "Right",
+               responseArea.withHeight(12).withWidth(40).translated(4, 0),
+               Justification::centredLeft,
+               false);
+  }
+
   g.setColour(Colours::white);
-  g.strokePath(responseCurve, PathStrokeType(2.f));
+  g.strokePath(magnitudeCurve, PathStrokeType(2.f));
 }
 
 void
 ResponseCurveComponent::resized()
 {
-  using namespace juce;
-  background = Image(Image::PixelFormat::RGB, getWidth(), getHeight(), true);
+  updateBackground();
 
-  Graphics g(background);
+  auto analysisArea = getAnalysisArea();
+  waterfall.setSize(analysisArea.getWidth(), analysisArea.getHeight());
+}
+
+void
+ResponseCurveComponent::updateBackground()
+{
+  if (getWidth() <= 0 || getHeight() <= 0)
+    return;
+
+  // rendered at the display's pixel density, and kept for the next editor of
+  // the same size
+  backgroundScale =
+    juce::Component::getApproximateScaleFactorForComponent(this);
+  background = backgroundCache->getImage(
+    getWidth(), getHeight(), backgroundScale, [this](juce::Graphics& g) {
+      renderBackground(g);
+    });
+}
+
+void
+ResponseCurveComponent::renderBackground(juce::Graphics& g)
+{
+  using namespace juce;
 
   Array<float> freqs{ 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000 };
   auto renderArea = getAnalysisArea();
@@ -566,6 +1134,51 @@ ResponseCurveComponent::getAnalysisArea()
   bounds.removeFromBottom(4);
   return bounds;
 }
+//==============================================================================
+void
+LevelMeterComponent::paint(juce::Graphics& g)
+{
+  using namespace juce;
+
+  auto bounds = getLocalBounds().toFloat();
+  auto correlationArea = bounds.removeFromBottom(8.f);
+
+  // -60 dB to 0 dB
+  auto toHeight = [&bounds](float gain) {
+    auto db = Decibels::gainToDecibels(gain, -60.f);
+    return jmap(jlimit(-60.f, 0.f, db), -60.f, 0.f, 0.f, bounds.getHeight());
+  };
+
+  auto barWidth = bounds.getWidth() * 0.5f;
+  for (int ch = 0; ch < 2; ++ch) {
+    auto bar = bounds.withX(bounds.getX() + ch * barWidth)
+                 .withWidth(barWidth)
+                 .reduced(2.f, 0.f);
+
+    g.setColour(Colour(45u, 96u, 105u));
+    g.fillRect(bar.withTop(bar.getBottom() - toHeight(meter.getRms(ch))));
+
+    g.setColour(Colour(58u, 245u, 245u));
+    auto peakY = bar.getBottom() - toHeight(meter.getPeak(ch));
+    g.drawHorizontalLine(roundToInt(peakY), bar.getX(), bar.getRight());
+  }
+
+  // the marker sits in the middle for uncorrelated signals and at the right
+  // for mono
+  auto correlation = meter.getCorrelation();
+  g.setColour(Colours::darkgrey);
+  g.fillRect(correlationArea.reduced(2.f, 3.f));
+  g.setColour(correlation < 0.f ? Colour(255u, 31u, 172u)
+                                : Colour(255u, 195u, 63u));
+  auto x = jmap(correlation,
+                -1.f,
+                1.f,
+                correlationArea.getX(),
+                correlationArea.getRight());
+  g.fillRect(Rectangle<float>(2.f, correlationArea.getHeight())
+               .withCentre({ x, correlationArea.getCentreY() }));
+}
+
 //==============================================================================
 SimpleEqAudioProcessorEditor::SimpleEqAudioProcessorEditor(
   SimpleEqAudioProcessor& p)
@@ -581,35 +1194,17 @@ SimpleEqAudioProcessorEditor::SimpleEqAudioProcessorEditor(
   , highCutSlopeSlider(*audioProcessor.apvts.getParameter("HighCut Slope"),
                        "dB/Oct")
   , responseCurveComponent(audioProcessor)
-  , peakFreqSliderAttachment(audioProcessor.apvts, "Peak Freq", peakFreqSlider)
-  , peakGainSliderAttachment(audioProcessor.apvts, "Peak Gain", peakGainSlider)
-  , peakQualitySliderAttachment(audioProcessor.apvts,
-                                "Peak Quality",
-                                peakQualitySlider)
-  , lowCutFreqSliderAttachment(audioProcessor.apvts,
-                               "LowCut Freq",
-                               lowCutFreqSlider)
-  , highCutFreqSliderAttachment(audioProcessor.apvts,
-                                "HighCut Freq",
-                                highCutFreqSlider)
-  , lowCutSlopeAttachment(audioProcessor.apvts,
-                          "LowCut Slope",
-                          lowCutSlopeSlider)
-  , highCutSlopeAttachment(audioProcessor.apvts,
-                           "HighCut Slope",
-                           highCutSlopeSlider)
-  , lowCutBypassButtonAttachment(audioProcessor.apvts,
-                                 "LowCut Bypassed",
-                                 lowCutBypassButton)
-  , highCutBypassButtonAttachment(audioProcessor.apvts,
-                                  "HighCut Bypassed",
-                                  highCutBypassButton)
-  , peakBypassButtonAttachment(audioProcessor.apvts,
-                               "Peak Bypassed",
-                               peakBypassButton)
+  , outputMeterComponent(audioProcessor.outputMeter)
   , analyzerEnabledButtonAttachment(audioProcessor.apvts,
                                     "Analyzer Enabled",
                                     analyzerEnabledButton)
+  , channelLinkButtonAttachment(audioProcessor.apvts,
+                                "Channel Link",
+                                channelLinkButton)
+  , morphSliderAttachment(audioProcessor.apvts, "Morph", morphSlider)
+  , morphEnabledButtonAttachment(audioProcessor.apvts,
+                                 "Morph Enabled",
+                                 morphEnabledButton)
 {
   // Make sure that before the constructor has finished, you've set the
   // editor's size to whatever you need it to be.
@@ -638,10 +1233,10 @@ SimpleEqAudioProcessorEditor::SimpleEqAudioProcessorEditor(
     addAndMakeVisible(comp);
   }
 
-  peakBypassButton.setLookAndFeel(&lnf);
-  lowCutBypassButton.setLookAndFeel(&lnf);
-  highCutBypassButton.setLookAndFeel(&lnf);
-  analyzerEnabledButton.setLookAndFeel(&lnf);
+  peakBypassButton.setLookAndFeel(&lnf.get());
+  lowCutBypassButton.setLookAndFeel(&lnf.get());
+  highCutBypassButton.setLookAndFeel(&lnf.get());
+  analyzerEnabledButton.setLookAndFeel(&lnf.get());
 
   auto safePtr =
     juce::Component::SafePointer<SimpleEqAudioProcessorEditor>(this);
@@ -677,7 +1272,131 @@ SimpleEqAudioProcessorEditor::SimpleEqAudioProcessorEditor(
       comp->responseCurveComponent.toggleAnalysisEnablement(enabled);
     }
   };
-  setSize(600, 400);
+
+  analyzerViewSelector.addItemList(
+    { "Output", "Input + Output", "Difference", "Waterfall" }, 1);
+  analyzerViewSelector.setSelectedItemIndex(0, juce::dontSendNotification);
+  analyzerViewSelector.onChange = [safePtr]() {
+    if (auto* comp = safePtr.getComponent()) {
+      comp->responseCurveComponent.setAnalyzerView(static_cast<AnalyzerView>(
+        comp->analyzerViewSelector.getSelectedItemIndex()));
+    }
+  };
+
+  overlaySelector.addItemList({ "Magnitude", "Phase", "Group Delay" }, 1);
+  overlaySelector.setSelectedItemIndex(0, juce::dontSendNotification);
+  overlaySelector.onChange = [safePtr]() {
+    if (auto* comp = safePtr.getComponent()) {
+      comp->responseCurveComponent.setOverlay(static_cast<ResponseOverlay>(
+        comp->overlaySelector.getSelectedItemIndex()));
+    }
+  };
+
+  // the attachment selects by index, so the items must be in before it is
+  stereoModeSelector.addItemList(
+    audioProcessor.apvts.getParameter("Stereo Mode")->getAllValueStrings(), 1);
+  stereoModeSelectorAttachment = std::make_unique<APVTS::ComboBoxAttachment>(
+    audioProcessor.apvts, "Stereo Mode", stereoModeSelector);
+
+  editedSetSelector.addItem("Main", MainParameters + 1);
+  editedSetSelector.addItem("Side", SideParameters + 1);
+  editedSetSelector.addItem("Right", RightParameters + 1);
+  editedSetSelector.onChange = [safePtr]() {
+    if (auto* comp = safePtr.getComponent()) {
+      comp->editParameterSet(static_cast<ChainParameterSet>(
+        comp->editedSetSelector.getSelectedId() - 1));
+    }
+  };
+  editedSetSelector.setSelectedId(MainParameters + 1,
+                                  juce::dontSendNotification);
+  editParameterSet(MainParameters);
+
+  // the attachment only shows the link. clicks go through the processor, which
+  // copies the Right set when the channels are unlinked
+  channelLinkButton.setClickingTogglesState(false);
+  channelLinkButton.onClick = [safePtr]() {
+    if (auto* comp = safePtr.getComponent()) {
+      comp->audioProcessor.setChannelsLinked(
+        !comp->channelLinkButton.getToggleState());
+    }
+  };
+
+  captureAButton.onClick = [safePtr]() {
+    if (auto* comp = safePtr.getComponent()) {
+      auto& processor = comp->audioProcessor;
+      processor.setMorphSnapshot(0, getChainSettings(processor.apvts));
+    }
+  };
+  captureBButton.onClick = [safePtr]() {
+    if (auto* comp = safePtr.getComponent()) {
+      auto& processor = comp->audioProcessor;
+      processor.setMorphSnapshot(1, getChainSettings(processor.apvts));
+    }
+  };
+
+  loadPresetsButton.onClick = [safePtr]() {
+    auto* comp = safePtr.getComponent();
+    if (comp == nullptr)
+      return;
+
+    comp->presetChooser = std::make_unique<juce::FileChooser>(
+      "Open a preset library", juce::File(), "*");
+    comp->presetChooser->launchAsync(
+      juce::FileBrowserComponent::openMode |
+        juce::FileBrowserComponent::canSelectFiles,
+      [safePtr](const juce::FileChooser& chooser) {
+        auto* comp = safePtr.getComponent();
+        auto file = chooser.getResult();
+        if (comp == nullptr || !file.existsAsFile())
+          return;
+
+        comp->audioProcessor.loadPresetLibrary(file);
+        comp->updatePresetSelector();
+      });
+  };
+
+  presetSelector.setTextWhenNoChoicesAvailable("No presets");
+  presetSelector.onChange = [safePtr]() {
+    if (auto* comp = safePtr.getComponent()) {
+      comp->audioProcessor.recallPreset(
+        comp->presetSelector.getSelectedItemIndex());
+    }
+  };
+  updatePresetSelector();
+
+  optionsButton.onClick = [safePtr]() {
+    auto* comp = safePtr.getComponent();
+    if (comp == nullptr)
+      return;
+
+    const auto compact =
+      comp->audioProcessor.getMemoryBudget() == MemoryBudget_Compact;
+
+    juce::PopupMenu menu;
+    menu.addItem("Compact Memory", true, compact, [safePtr, compact]() {
+      if (auto* comp = safePtr.getComponent()) {
+        auto& processor = comp->audioProcessor;
+        processor.setMemoryBudget(compact ? MemoryBudget_Full
+                                          : MemoryBudget_Compact);
+
+        // not a parameter, so the host has to be told the state changed
+        processor.updateHostDisplay(
+          juce::AudioProcessor::ChangeDetails().withNonParameterStateChanged(
+            true));
+      }
+    });
+    menu.addItem("Copy Memory Report", [safePtr]() {
+      if (auto* comp = safePtr.getComponent()) {
+        juce::SystemClipboard::copyTextToClipboard(
+          comp->audioProcessor.getMemoryFootprint().toString());
+      }
+    });
+
+    menu.showMenuAsync(
+      juce::PopupMenu::Options().withTargetComponent(&comp->optionsButton));
+  };
+
+  setSize(600, 430);
 }
 
 SimpleEqAudioProcessorEditor::~SimpleEqAudioProcessorEditor()
@@ -706,16 +1425,45 @@ SimpleEqAudioProcessorEditor::resized()
   // subcomponents in your editor..
   auto bounds = getLocalBounds();
 
+  auto morphArea = bounds.removeFromBottom(30).reduced(5);
+  captureAButton.setBounds(morphArea.removeFromLeft(30));
+  morphArea.removeFromLeft(5);
+  morphSlider.setBounds(morphArea.removeFromLeft(160));
+  morphArea.removeFromLeft(5);
+  captureBButton.setBounds(morphArea.removeFromLeft(30));
+  morphArea.removeFromLeft(5);
+  morphEnabledButton.setBounds(morphArea.removeFromLeft(80));
+
+  presetSelector.setBounds(morphArea.removeFromRight(150));
+  morphArea.removeFromRight(5);
+  loadPresetsButton.setBounds(morphArea.removeFromRight(80));
+  morphArea.removeFromRight(5);
+  optionsButton.setBounds(morphArea.removeFromRight(30));
+
   auto analyzerEnabledArea = bounds.removeFromTop(25);
   analyzerEnabledArea.setWidth(100);
   analyzerEnabledArea.setX(5);
   analyzerEnabledArea.removeFromTop(5);
   analyzerEnabledButton.setBounds(analyzerEnabledArea);
+
+  auto overlayArea = getLocalBounds().removeFromTop(25);
+  overlayArea.removeFromTop(5);
+  overlayArea.removeFromRight(5);
+  overlaySelector.setBounds(overlayArea.removeFromRight(110));
+  overlayArea.removeFromRight(5);
+  analyzerViewSelector.setBounds(overlayArea.removeFromRight(120));
+  overlayArea.removeFromRight(5);
+  editedSetSelector.setBounds(overlayArea.removeFromRight(70));
+  overlayArea.removeFromRight(5);
+  stereoModeSelector.setBounds(overlayArea.removeFromRight(90));
+  overlayArea.removeFromRight(5);
+  channelLinkButton.setBounds(overlayArea.removeFromRight(55));
   bounds.removeFromTop(5);
 
   float hRatio = 25.f / 100.f;
   auto responseArea = bounds.removeFromTop(bounds.getHeight() * hRatio);
 
+  outputMeterComponent.setBounds(responseArea.removeFromRight(30));
   responseCurveComponent.setBounds(responseArea);
 
   bounds.removeFromTop(10);
@@ -739,6 +1487,56 @@ SimpleEqAudioProcessorEditor::resized()
   peakQualitySlider.setBounds(bounds);
 }
 
+void
+SimpleEqAudioProcessorEditor::editParameterSet(ChainParameterSet set)
+{
+  auto& apvts = audioProcessor.apvts;
+  const auto& ids = getChainParameterIDs(set);
+
+  auto attach = [&apvts](std::unique_ptr<Attachment>& attachment,
+                         RotarySliderWithLabels& slider,
+                         const juce::String& parameterID) {
+    // the old attachment has to let go of the slider first
+    attachment.reset();
+    slider.setParameter(*apvts.getParameter(parameterID));
+    attachment = std::make_unique<Attachment>(apvts, parameterID, slider);
+  };
+
+  attach(peakFreqSliderAttachment, peakFreqSlider, ids.peakFreq);
+  attach(peakGainSliderAttachment, peakGainSlider, ids.peakGain);
+  attach(peakQualitySliderAttachment, peakQualitySlider, ids.peakQuality);
+  attach(lowCutFreqSliderAttachment, lowCutFreqSlider, ids.lowCutFreq);
+  attach(highCutFreqSliderAttachment, highCutFreqSlider, ids.highCutFreq);
+  attach(lowCutSlopeAttachment, lowCutSlopeSlider, ids.lowCutSlope);
+  attach(highCutSlopeAttachment, highCutSlopeSlider, ids.highCutSlope);
+
+  auto attachButton = [&apvts](std::unique_ptr<ButtonAttachment>& attachment,
+                               juce::Button& button,
+                               const juce::String& parameterID) {
+    attachment.reset();
+    attachment =
+      std::make_unique<ButtonAttachment>(apvts, parameterID, button);
+  };
+
+  // attaching sets the toggle state, which enables or disables the knobs
+  attachButton(
+    lowCutBypassButtonAttachment, lowCutBypassButton, ids.lowCutBypassed);
+  attachButton(peakBypassButtonAttachment, peakBypassButton, ids.peakBypassed);
+  attachButton(
+    highCutBypassButtonAttachment, highCutBypassButton, ids.highCutBypassed);
+}
+
+void
+SimpleEqAudioProcessorEditor::updatePresetSelector()
+{
+  const auto& library = audioProcessor.getPresetLibrary();
+
+  presetSelector.clear(juce::dontSendNotification);
+  for (int i = 0; i < library.getNumPresets(); ++i) {
+    presetSelector.addItem(library.getName(i), i + 1);
+  }
+}
+
 std::vector<juce::Component*>
 SimpleEqAudioProcessorEditor::getComps()
 {
@@ -746,6 +1544,11 @@ SimpleEqAudioProcessorEditor::getComps()
     &peakFreqSlider,     &peakGainSlider,         &peakQualitySlider,
     &lowCutFreqSlider,   &highCutFreqSlider,      &lowCutSlopeSlider,
     &highCutSlopeSlider, &responseCurveComponent, &lowCutBypassButton,
-    &peakBypassButton,   &highCutBypassButton,    &analyzerEnabledButton
+    &peakBypassButton,   &highCutBypassButton,    &analyzerEnabledButton,
+    &overlaySelector,    &analyzerViewSelector,   &outputMeterComponent,
+    &captureAButton,     &captureBButton,         &morphSlider,
+    &morphEnabledButton, &loadPresetsButton,      &presetSelector,
+    &stereoModeSelector, &editedSetSelector,      &channelLinkButton,
+    &optionsButton
   };
 }
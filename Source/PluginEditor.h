@@ -10,136 +10,181 @@
 
 #include <JuceHeader.h>
 
+#include "BackgroundCache.h"
 #include "PluginProcessor.h"
+#include "ResponseCurve.h"
+#include "SpectrumAnalysis.h"
 
-enum FFTOrder
+// the four analyzer taps, before and after the EQ
+enum AnalyzerTap
 {
-  order2048 = 11,
-  order4096 = 12,
-  order8192 = 13
+  AnalyzerTap_PostLeft,
+  AnalyzerTap_PostRight,
+  AnalyzerTap_PreLeft,
+  AnalyzerTap_PreRight,
+  NumAnalyzerTaps
 };
 
-template<typename BlockType>
-struct FFTDataGenerator
+/* Runs the analyzer taps through one shared windowing and FFT stage.
+   Each frame only the newest window of each tap is transformed, all of them
+   with the same plan and window, one after the other, and taps that aren't
+   shown are skipped altogether.
+*/
+struct SpectrumAnalyzer
 {
-  // produces the FFT data from an audio buffer
-  void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData,
-                                  const float negativeInfinity)
-  {
-    const auto fftSize = getFFTSize();
-
-    fftData.assign(fftData.size(), 0);
-    auto* readIndex = audioData.getReadPointer(0);
-    std::copy(readIndex, readIndex + fftSize, fftData.begin());
+  using BlockType = SimpleEqAudioProcessor::BlockType;
 
-    // first apply a windowing function to our data
-    window->multiplyWithWindowingTable(fftData.data(), fftSize);
+  SpectrumAnalyzer(SimpleEqAudioProcessor& p);
 
-    // then render our FFT data..
-    forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());
+  void setTapEnabled(AnalyzerTap tap, bool enabled);
+  bool isTapEnabled(AnalyzerTap tap) const { return taps[tap].enabled; }
 
-    int numBins = (int)fftSize / 2;
+  // pulls the new audio from the enabled taps and transforms it, returns
+  // false if there was none
+  bool process();
 
-    // normalize the fft values
-    for (int i = 0; i < numBins; ++i) {
-      fftData[i] /= (float)numBins;
-    }
-
-    // conver them to decibels
-    for (int i = 0; i < numBins; ++i) {
-      fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
-    }
+  // the spectra start again from silence at the new size
+  void setOrder(FFTOrder newOrder);
 
-    fftDataFifo.push(fftData);
-  }
-
-  void changeOrder(FFTOrder newOrder)
-  {
-    // when we change the order, recreate the window, forwardFFT, fifo, and
-    // fftData
-    // with new size
-    order = newOrder;
-    auto fftSize = getFFTSize();
-    forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-    window = std::make_unique<juce::dsp::WindowingFunction<float>>(
-      fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
-    fftData.clear();
-    fftData.resize(fftSize * 2, 0);
-    fftDataFifo.prepare(fftData.size());
-  }
-  //===========================================================================
   int getFFTSize() const { return 1 << order; }
-  int getNumAvailbleFFTDataBlocks() const
+  int getNumBins() const { return getFFTSize() / 2; }
+
+  // decibels per bin, floored at negativeInfinity
+  const float* getSpectrum(AnalyzerTap tap) const
   {
-    return fftDataFifo.getNumAvailableForReading();
+    return taps[tap].spectrum.data();
   }
-  //===========================================================================
-  bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
+
+  static constexpr float negativeInfinity = -48.f;
+
+  size_t getMemoryBytes() const;
 
 private:
-  FFTOrder order;
-  BlockType fftData;
-  std::unique_ptr<juce::dsp::FFT> forwardFFT;
+  struct Tap
+  {
+    SingleChannelSampleFifo<BlockType>* fifo = nullptr;
+    juce::AudioBuffer<float> history;
+    std::vector<float> spectrum;
+    bool enabled = false, hasNewAudio = false;
+  };
+
+  FFTOrder order = order2048;
+  juce::SharedResourcePointer<SharedFFTResources> sharedResources;
+
+  std::array<Tap, NumAnalyzerTaps> taps;
 
-  std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+  // one row per tap, the FFT needs twice its size to work in
+  juce::AudioBuffer<float> workspace;
+  BlockType incoming;
 
-  Fifo<BlockType> fftDataFifo;
+  void prepare();
+  void pullAudio(Tap& tap);
 };
 
-template<typename PathType>
-struct AnalyzerPathGenerator
+/* Steps the analyzer's frame rate and FFT order down when it goes over its
+   CPU budget, or when the message thread is too busy to run its timer on
+   time, and back up once there has been headroom for a while.
+   Only the newest window is transformed each frame, so a lower frame rate
+   also means less overlap between the windows analyzed.
+*/
+struct AnalyzerQualityGovernor
 {
-  /* converts 'renderData[] into a juce::Path*/
-  void generatePath(const std::vector<float>& renderData,
-                    juce::Rectangle<float> fftBounds,
-                    int fftSize,
-                    float binWidth,
-                    float negativeInfinity)
+  struct Level
   {
-    auto top = fftBounds.getY();
-    auto bottom = fftBounds.getHeight();
-    auto width = fftBounds.getWidth();
+    int frameRateHz;
+    FFTOrder order;
+  };
 
-    int numBins = (int)fftSize / 2;
+  AnalyzerQualityGovernor();
 
-    PathType p;
-    p.preallocateSpace(3 * (int)width);
-    auto map = [bottom, top, negativeInfinity](float v) {
-      return juce::jmap(v, negativeInfinity, 0.f, float(bottom), top);
-    };
+  // the best level uses maxFrameRateHz and maxOrder, and each step down
+  // halves the frame rate or the FFT size, in turn, until both are at their
+  // minimums
+  void setBounds(int minFrameRateHz,
+                 int maxFrameRateHz,
+                 FFTOrder minOrder,
+                 FFTOrder maxOrder);
 
-    auto y = map(renderData[0]);
+  // the share of one core the analyzer may use
+  void setBudget(double proportionOfCore) { budget = proportionOfCore; }
 
-    jassert(!std::isnan(y) && !std::isinf(y));
+  // reports a frame's processing time and the time since the previous frame,
+  // returns true if the level changed
+  bool update(double processingSeconds, double intervalSeconds);
 
-    p.startNewSubPath(0, y);
+  const Level& getLevel() const { return levels[current]; }
 
-    const int pathResolution =
-      2; // you can draw line-to's every 'pathResolution'  pixels
-    for (int binNum = 1; binNum < numBins; binNum += pathResolution) {
-      y = map(renderData[binNum]);
+private:
+  std::vector<Level> levels;
+  int current = 0;
 
-      jassert(!std::isnan(y) && !std::isinf(y));
+  double budget = 0.02;
+  double smoothedLoad = 0, smoothedLateness = 0;
+  int framesAtLevel = 0;
 
-      if (!std::isnan(y) && !std::isinf(y)) {
-        auto binFreq = binNum * binWidth;
-        auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
-        auto binX = std::floor(width * normalizedBinX);
-        p.lineTo(binX, y);
-      }
-    }
-    pathFifo.push(p);
-  }
+  void changeLevel(int newLevel);
+};
 
-  int getNumPathsAvailable() const
-  {
-    return pathFifo.getNumAvailableForReading();
-  }
+/* Which pixel column each analyzer bin lands on, 20 Hz to 20 kHz across
+   'width'. Shared by the spectrum paths and the waterfall so a bin is in the
+   same place in both, and only rebuilt when the FFT size, sample rate or
+   width change.
+*/
+struct SpectrumPixelMap
+{
+  void prepare(int numBins, float binWidth, int width);
+  bool isPreparedFor(int numBins, float binWidth, int width) const;
+
+  int getNumBins() const { return (int)pixels.size(); }
+  int getWidth() const { return width; }
+
+  // from the left edge, bins outside 20 Hz to 20 kHz are off either end
+  int getPixel(int bin) const { return pixels[(size_t)bin]; }
+
+private:
+  std::vector<int> pixels;
+  float binWidth = 0.f;
+  int width = 0;
+};
+
+// a path through 'decibels', one per bin of 'pixelMap', mapped from minDb and
+// maxDb to the bottom and top of 'bounds'
+juce::Path
+makeSpectrumPath(const float* decibels,
+                 const SpectrumPixelMap& pixelMap,
+                 juce::Rectangle<float> bounds,
+                 float minDb,
+                 float maxDb);
+
+/* A scrolling spectrogram, newest frame at the top, kept in an image used as
+   a ring of rows. Each frame is bucketed into a single row that overwrites
+   the oldest one, so nothing else in the image is touched, and drawing it is
+   at most two blits, one either side of the newest row.
+*/
+struct WaterfallImage
+{
+  WaterfallImage();
+
+  // one pixel per column and one row per frame, cleared
+  void setSize(int width, int height);
+  void clear();
 
-  bool getPath(PathType& path) { return pathFifo.pull(path); }
+  // 'pixelMap' has to be as wide as the image
+  void addFrame(const float* decibels,
+                const SpectrumPixelMap& pixelMap,
+                float minDb,
+                float maxDb);
+
+  void draw(juce::Graphics& g, juce::Rectangle<int> area) const;
+
+  size_t getMemoryBytes() const;
 
 private:
-  Fifo<PathType> pathFifo;
+  juce::Image image;
+  int newestRow = 0;
+
+  std::vector<float> rowLevels;
+  std::array<juce::Colour, 256> palette;
 };
 
 struct LookAndFeel : juce::LookAndFeel_V4
@@ -168,7 +213,7 @@ struct RotarySliderWithLabels : juce::Slider
     , param(&rap)
     , suffix(unitSuffix)
   {
-    setLookAndFeel(&lnf);
+    setLookAndFeel(&lnf.get());
   }
   ~RotarySliderWithLabels() { setLookAndFeel(nullptr); }
 
@@ -180,79 +225,52 @@ struct RotarySliderWithLabels : juce::Slider
 
   juce::Array<LabelPos> labels;
 
+  // the parameter whose value is displayed, when the slider is attached to
+  // another one
+  void setParameter(juce::RangedAudioParameter& rap)
+  {
+    param = &rap;
+    repaint();
+  }
+
   void paint(juce::Graphics& g) override;
   juce::Rectangle<int> getSliderBounds() const;
   int getTextHeight() const { return 14; }
   juce::String getDisplayString() const;
 
 private:
-  LookAndFeel lnf;
+  // one LookAndFeel for every slider in the process
+  juce::SharedResourcePointer<LookAndFeel> lnf;
 
   juce::RangedAudioParameter* param;
   juce::String suffix;
 };
 
-struct PathProducer
+// what the analyzer shows. the input spectrum is only analyzed when it is
+// shown
+enum AnalyzerView
 {
-  PathProducer(SingleChannelSampleFifo<SimpleEqAudioProcessor::BlockType>& scsf)
-    : leftChannelFifo(&scsf)
-  {
-    leftChannelFFTDataGenerator.changeOrder(FFTOrder::order2048);
-    monoBuffer.setSize(1, leftChannelFFTDataGenerator.getFFTSize());
-  }
-  void process(juce::Rectangle<float> fftBounds, double sampleRate);
-  juce::Path getPath() { return leftChannelFFTPath; }
-
-private:
-  SingleChannelSampleFifo<SimpleEqAudioProcessor::BlockType>* leftChannelFifo;
-  juce::AudioBuffer<float> monoBuffer;
-
-  FFTDataGenerator<std::vector<float>> leftChannelFFTDataGenerator;
-
-  AnalyzerPathGenerator<juce::Path> pathProducer;
+  AnalyzerView_Output,
+  AnalyzerView_InputAndOutput,
+  AnalyzerView_Difference,
+  AnalyzerView_Waterfall,
+};
 
-  juce::Path leftChannelFFTPath;
+// drawn over the magnitude curve
+enum ResponseOverlay
+{
+  ResponseOverlay_None,
+  ResponseOverlay_Phase,
+  ResponseOverlay_GroupDelay,
 };
 
 struct ResponseCurveComponent
   : juce::Component
-  , juce::AudioProcessorParameter::Listener
   , juce::Timer
 {
   ResponseCurveComponent(SimpleEqAudioProcessor&);
   ~ResponseCurveComponent();
 
-  /** Receives a callback when a parameter has been changed.
-
-          IMPORTANT NOTE: This will be called synchronously when a parameter
-   changes, and many audio processors will change their parameter during their
-   audio callback. This means that not only has your handler code got to be
-   completely thread-safe, but it's also got to be VERY fast, and avoid
-   blocking. If you need to handle this event on your message thread, use this
-   callback to trigger an AsyncUpdater or ChangeBroadcaster which you can
-   respond to on the message thread.
-      */
-  void parameterValueChanged(int parameterIndex, float newValue) override;
-
-  /** Indicates that a parameter change gesture has started.
-
-      E.g. if the user is dragging a slider, this would be called with
-     gestureIsStarting being true when they first press the mouse button, and it
-     will be called again with gestureIsStarting being false when they release
-     it.
-
-      IMPORTANT NOTE: This will be called synchronously, and many audio
-     processors will call it during their audio callback. This means that not
-     only has your handler code got to be completely thread-safe, but it's also
-     got to be VERY fast, and avoid blocking. If you need to handle this event
-     on your message thread, use this callback to trigger an AsyncUpdater or
-     ChangeBroadcaster which you can respond to later on the message thread.
-  */
-  void parameterGestureChanged(int parameterIndex,
-                               bool gestureIsStarting) override
-  {
-  }
-
   /** The user-defined callback routine that actually gets called periodically.
 
 It's perfectly ok to call startTimer() or stopTimer() from within this
@@ -264,26 +282,93 @@ callback to change the subsequent intervals.
 
   void resized() override;
 
-  void toggleAnalysisEnablement(bool enabled)
-  {
-    shouldShowFFTAnalysis = enabled;
-  }
+  void toggleAnalysisEnablement(bool enabled);
+  void setAnalyzerView(AnalyzerView newView);
+
+  // limits for the adaptive analyzer quality, see AnalyzerQualityGovernor
+  void setAnalyzerQualityBounds(int minFrameRateHz,
+                                int maxFrameRateHz,
+                                FFTOrder minOrder,
+                                FFTOrder maxOrder);
+
+  void setOverlay(ResponseOverlay newOverlay) { overlay = newOverlay; }
+
+  void addMemoryFootprint(MemoryFootprint& footprint) const;
 
 private:
   SimpleEqAudioProcessor& audioProcessor;
-  juce::Atomic<bool> parametersChanged{ false };
-  MonoChain monoChain;
-
+  ChainSettings chainSettings;
+  juce::uint32 chainSettingsVersion = 0;
+  bool chainSettingsValid = false;
+  IncrementalFrequencyResponse responseCurve;
+  ResponseOverlay overlay = ResponseOverlay_None;
+
+  // the side chain in Mid/Side mode, or the right channel when it isn't linked,
+  // drawn along with the main curve. MainParameters when there's only the one
+  // curve
+  ChainParameterSet secondarySet = MainParameters;
+  ChainSettings secondaryChainSettings;
+  juce::uint32 secondaryChainSettingsVersion = 0;
+  bool secondaryChainSettingsValid = false;
+  IncrementalFrequencyResponse secondaryResponseCurve;
+
+  std::atomic<float>* stereoMode = nullptr;
+  std::atomic<float>* channelLink = nullptr;
+
+  ChainParameterSet getSecondaryParameterSet() const;
+
+  // reads the parameters again if they changed since the last call
   void updateChain();
 
   juce::Image background;
+  float backgroundScale = 0.f;
+  juce::SharedResourcePointer<BackgroundCache> backgroundCache;
+
+  void updateBackground();
+
+  void renderBackground(juce::Graphics& g);
 
   juce::Rectangle<int> getRenderArea();
   juce::Rectangle<int> getAnalysisArea();
 
-  PathProducer leftPathProducer, rightPathProducer;
+  SpectrumAnalyzer analyzer;
+  SpectrumPixelMap pixelMap;
+  std::array<juce::Path, NumAnalyzerTaps> tapPaths;
+  juce::Path differencePath;
+  std::vector<float> difference;
+
+  // the output, both channels averaged
+  WaterfallImage waterfall;
+  std::vector<float> waterfallFrame;
 
   bool shouldShowFFTAnalysis = true;
+  AnalyzerView analyzerView = AnalyzerView_Output;
+
+  AnalyzerQualityGovernor qualityGovernor;
+  juce::int64 lastTimerTicks = 0;
+
+  void updateAnalyzerTaps();
+  void updateAnalyzerPaths();
+};
+
+/* Peak and RMS bars for each output channel, with the correlation drawn as a
+   line underneath. Polls the processor's StereoMeter at frame rate.
+*/
+struct LevelMeterComponent
+  : juce::Component
+  , juce::Timer
+{
+  LevelMeterComponent(StereoMeter& m)
+    : meter(m)
+  {
+    startTimerHz(30);
+  }
+
+  void timerCallback() override { repaint(); }
+  void paint(juce::Graphics& g) override;
+
+private:
+  StereoMeter& meter;
 };
 
 struct PowerButton : juce::ToggleButton
@@ -323,6 +408,11 @@ public:
   void paint(juce::Graphics&) override;
   void resized() override;
 
+  void addMemoryFootprint(MemoryFootprint& footprint) const
+  {
+    responseCurveComponent.addMemoryFootprint(footprint);
+  }
+
 private:
   // This reference is provided as a quick way for your editor to
   // access the processor object that created it.
@@ -332,22 +422,56 @@ private:
     lowCutFreqSlider, highCutFreqSlider, lowCutSlopeSlider, highCutSlopeSlider;
 
   ResponseCurveComponent responseCurveComponent;
+  LevelMeterComponent outputMeterComponent;
 
   using APVTS = juce::AudioProcessorValueTreeState;
   using Attachment = APVTS::SliderAttachment;
-  Attachment peakFreqSliderAttachment, peakGainSliderAttachment,
-    peakQualitySliderAttachment, lowCutFreqSliderAttachment,
-    highCutFreqSliderAttachment, lowCutSlopeAttachment, highCutSlopeAttachment;
 
   PowerButton lowCutBypassButton, peakBypassButton, highCutBypassButton;
   AnalyzerButton analyzerEnabledButton;
+  juce::ComboBox overlaySelector, analyzerViewSelector;
 
   using ButtonAttachment = APVTS::ButtonAttachment;
-  ButtonAttachment lowCutBypassButtonAttachment, peakBypassButtonAttachment,
-    highCutBypassButtonAttachment, analyzerEnabledButtonAttachment;
+  ButtonAttachment analyzerEnabledButtonAttachment;
+
+  // the knobs and bypass buttons edit one parameter set at a time, they are
+  // attached again when another set is picked
+  std::unique_ptr<Attachment> peakFreqSliderAttachment,
+    peakGainSliderAttachment, peakQualitySliderAttachment,
+    lowCutFreqSliderAttachment, highCutFreqSliderAttachment,
+    lowCutSlopeAttachment, highCutSlopeAttachment;
+  std::unique_ptr<ButtonAttachment> lowCutBypassButtonAttachment,
+    peakBypassButtonAttachment, highCutBypassButtonAttachment;
+
+  juce::ComboBox stereoModeSelector, editedSetSelector;
+  std::unique_ptr<APVTS::ComboBoxAttachment> stereoModeSelectorAttachment;
+
+  juce::ToggleButton channelLinkButton{ "Link" };
+  ButtonAttachment channelLinkButtonAttachment;
+
+  void editParameterSet(ChainParameterSet set);
+
+  // A and B capture the current settings as the two morph snapshots
+  juce::TextButton captureAButton{ "A" }, captureBButton{ "B" };
+  juce::ToggleButton morphEnabledButton{ "Morph" };
+  juce::Slider morphSlider{ juce::Slider::LinearHorizontal,
+                            juce::Slider::NoTextBox };
+  Attachment morphSliderAttachment;
+  ButtonAttachment morphEnabledButtonAttachment;
+
+  // recalls presets from a library file into the main settings
+  juce::TextButton loadPresetsButton{ "Presets..." };
+  juce::ComboBox presetSelector;
+  std::unique_ptr<juce::FileChooser> presetChooser;
+
+  void updatePresetSelector();
+
+  // the instance's settings that aren't parameters, and the memory report
+  juce::TextButton optionsButton{ "..." };
+
   std::vector<juce::Component*> getComps();
 
-  LookAndFeel lnf;
+  juce::SharedResourcePointer<LookAndFeel> lnf;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleEqAudioProcessorEditor)
 };
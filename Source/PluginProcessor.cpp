@@ -8,6 +8,8 @@
 
 #include "PluginProcessor.h"
 
+#include "OfflineRenderer.h"
+#include "ParameterSnapshot.h"
 #include "PluginEditor.h"
 
 //==============================================================================
@@ -24,6 +26,25 @@ SimpleEqAudioProcessor::SimpleEqAudioProcessor()
     )
 #endif
 {
+  bypassParameter =
+    dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("Bypass"));
+  jassert(bypassParameter != nullptr);
+
+  morphAmount = apvts.getRawParameterValue("Morph");
+  morphEnabled = apvts.getRawParameterValue("Morph Enabled");
+  stereoMode = apvts.getRawParameterValue("Stereo Mode");
+  channelLink = apvts.getRawParameterValue("Channel Link");
+
+  for (int set = 0; set < NumChainParameterSets; ++set) {
+    parameterSnapshots[set] = std::make_unique<ParameterSnapshot>(
+      apvts, static_cast<ChainParameterSet>(set));
+    audioParameterVersions[set] =
+      parameterSnapshots[set]->read(audioParameters[set]);
+  }
+
+  morphSnapshots.fill(getChainSettings(apvts));
+
+  updateParameterLayoutHashes();
 }
 
 SimpleEqAudioProcessor::~SimpleEqAudioProcessor() {}
@@ -68,7 +89,7 @@ SimpleEqAudioProcessor::isMidiEffect() const
 double
 SimpleEqAudioProcessor::getTailLengthSeconds() const
 {
-  return 0.0;
+  return tailLengthSeconds.load();
 }
 
 int
@@ -115,11 +136,54 @@ SimpleEqAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 
   leftChain.prepare(spec);
   rightChain.prepare(spec);
+  bandFilter.prepare(sampleRate);
+
+  appliedSettingsValid = false;
+  processMidSide = stereoMode->load() > 0.5f;
+  rampLengthSamples = juce::roundToInt(sampleRate * 0.02);
+
+  // start on the settings the first block will ask for, both channels of
+  // them, so nothing ramps in from the wrong ones
+  updateAudioParameters();
+  auto stereoSettings =
+    makeStereoChainSettings(audioParameters[MainParameters],
+                            audioParameters,
+                            processMidSide,
+                            isLinked());
+  jumpToSettings(stereoSettings);
+  updateTailLength(stereoSettings);
+
+  outputMeter.prepare(sampleRate);
+
+  // the analyzer hop doesn't follow the block size
+  {
+    const juce::ScopedLock sl(analyzerFifoLock);
+    analyzerFifosReady.store(false);
+
+    if (memoryBudget == MemoryBudget_Full || analyzerAttached)
+      prepareAnalyzerFifos();
+  }
 
-  updateFilters();
+  dryBuffer.setSize(2, samplesPerBlock, false, true, true);
+  fadeGains.resize(samplesPerBlock);
 
-  leftChannelFifo.prepare(samplesPerBlock);
-  rightChannelFifo.prepare(samplesPerBlock);
+  // room for the longest tail that gets primed, see startWarmUp
+  warmUpBuffer.setSize(
+    2, juce::roundToInt(sampleRate * maxWarmUpSeconds), false, true, true);
+  warmUpBuffer.clear();
+  warmUpWriteIndex = warmUpReadIndex = 0;
+  numWarmUpSamplesPending = 0;
+  warmingUp = false;
+
+  numSilentSamples = 0;
+  isSleeping = false;
+
+  wetGain.reset(sampleRate, 0.01);
+  wetGain.setCurrentAndTargetValue(bypassParameter->get() ||
+                                       (isIdentity(stereoSettings[0]) &&
+                                        isIdentity(stereoSettings[1]))
+                                     ? 0.f
+                                     : 1.f);
 
   osc.initialise([](float x) { return std::sin(x); });
 
@@ -178,10 +242,652 @@ SimpleEqAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
   for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
     buffer.clear(i, 0, buffer.getNumSamples());
 
-  updateFilters();
+  process(buffer, bypassParameter->get());
+  outputMeter.process(buffer);
+}
+
+void
+SimpleEqAudioProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer,
+                                             juce::MidiBuffer& midiMessages)
+{
+  juce::ScopedNoDenormals noDenormals;
+  process(buffer, true);
+  outputMeter.process(buffer);
+}
+
+void
+SimpleEqAudioProcessor::prepareAnalyzerFifos()
+{
+  const auto capacity = memoryBudget == MemoryBudget_Compact
+                          ? compactFifoCapacity
+                          : Fifo<BlockType>::DefaultCapacity;
+
+  auto hopSize = SingleChannelSampleFifo<BlockType>::DefaultHopSize;
+  leftChannelFifo.prepare(hopSize, capacity);
+  rightChannelFifo.prepare(hopSize, capacity);
+  preLeftChannelFifo.prepare(hopSize, capacity);
+  preRightChannelFifo.prepare(hopSize, capacity);
+
+  analyzerFifosReady.store(true);
+}
+
+void
+SimpleEqAudioProcessor::attachAnalyzer()
+{
+  const juce::ScopedLock sl(analyzerFifoLock);
+  analyzerAttached = true;
+
+  // the audio thread leaves the taps alone until they are ready
+  if (!analyzerFifosReady.load())
+    prepareAnalyzerFifos();
+}
+
+size_t
+getCoefficientBytes(const Filter& filter)
+{
+  return sizeof(Filter::Coefficients) +
+         size_t(filter.coefficients->coefficients.capacity()) * sizeof(float);
+}
+
+template<typename ChainType>
+size_t
+getCutFilterCoefficientBytes(const ChainType& chain)
+{
+  return getCoefficientBytes(chain.template get<0>()) +
+         getCoefficientBytes(chain.template get<1>()) +
+         getCoefficientBytes(chain.template get<2>()) +
+         getCoefficientBytes(chain.template get<3>());
+}
+
+MemoryFootprint
+SimpleEqAudioProcessor::getMemoryFootprint() const
+{
+  MemoryFootprint footprint;
+
+  // the chains, band filter, settings and meter all live inside the object
+  footprint.add("Processor", sizeof(*this));
+
+  size_t coefficientBytes = 0;
+  for (const auto* chain : { &leftChain, &rightChain }) {
+    coefficientBytes += getCutFilterCoefficientBytes(chain->get<LowCut>()) +
+                        getCoefficientBytes(chain->get<Peak>()) +
+                        getCutFilterCoefficientBytes(chain->get<HighCut>());
+  }
+  footprint.add("Filter coefficients", coefficientBytes);
+
+  footprint.add("Analyzer taps",
+                leftChannelFifo.getMemoryBytes() +
+                  rightChannelFifo.getMemoryBytes() +
+                  preLeftChannelFifo.getMemoryBytes() +
+                  preRightChannelFifo.getMemoryBytes());
+
+  footprint.add("Bypass crossfade and warm-up",
+                getMemoryBytes(dryBuffer) + getMemoryBytes(fadeGains) +
+                  getMemoryBytes(warmUpBuffer));
+
+  // mapped rather than allocated, the OS pages it in as presets are read
+  footprint.add("Preset library (mapped)",
+                size_t(presetLibrary.getNumPresets()) * sizeof(PresetRecord));
+
+  if (auto* editor =
+        dynamic_cast<SimpleEqAudioProcessorEditor*>(getActiveEditor()))
+    editor->addMemoryFootprint(footprint);
+
+  footprint.add(
+    "Editor backgrounds", editorBackgrounds->getMemoryBytes(), true);
+
+  return footprint;
+}
+
+juce::AudioProcessorParameter*
+SimpleEqAudioProcessor::getBypassParameter() const
+{
+  return bypassParameter;
+}
+
+void
+SimpleEqAudioProcessor::process(juce::AudioBuffer<float>& buffer,
+                                bool bypassed)
+{
+  const auto analyzerFifosReadyForBlock = analyzerFifosReady.load();
+
+  // before the parameters are read, so a Right set copied in after this is
+  // only used from the next block
+  const auto linked = isLinked();
+
+  if (analyzerFifosReadyForBlock && preAnalysisEnabled.load()) {
+    preLeftChannelFifo.update(buffer);
+    preRightChannelFifo.update(buffer);
+  }
+
+  updateAudioParameters();
+
+  auto chainSettings = audioParameters[MainParameters];
+
+  const auto morphing = morphEnabled->load() > 0.5f;
+  if (morphing) {
+    updateAudioMorphSnapshots();
+    chainSettings = morphChainSettings(
+      audioMorphSnapshots[0], audioMorphSnapshots[1], morphAmount->load());
+  }
+
+  const auto isTransparent =
+    !wetGain.isSmoothing() && wetGain.getCurrentValue() == 0.f;
+
+  // the filter states only make sense in the mode they ran in. a change of
+  // Stereo Mode fades the filters out, switches once nothing of them is heard
+  // and fades them back in, primed from the input recorded on the way out
+  const auto midSide = stereoMode->load() > 0.5f;
+  if ((isTransparent || isSleeping) && processMidSide != midSide) {
+    processMidSide = midSide;
+
+    // anything already primed was primed in the other mode
+    warmingUp = false;
+  }
+
+  const auto switchingMode = midSide != processMidSide;
+
+  auto stereoSettings = makeStereoChainSettings(
+    chainSettings, audioParameters, processMidSide, linked);
+  updateTailLength(stereoSettings);
+
+  // shared by every sub-block of this block. it grows with the number of
+  // bands the morph moves, so all of them keep up with it a block at a time
+  auto redesignBudget = std::numeric_limits<int>::max();
+  if (morphing)
+    redesignBudget =
+      juce::jmax(morphRedesignBudget, getNumChangedBands(stereoSettings));
+
+  const auto identity = bypassed || (isIdentity(stereoSettings[0]) &&
+                                     isIdentity(stereoSettings[1]));
+
+  if (identity && isTransparent) {
+    // nothing to design or process. just remember the input so the filters
+    // can be primed when they're needed again. the output is the input, and
+    // the analyzer still shows it
+    warmingUp = false;
+    recordWarmUpHistory(buffer);
+    feedOutputTaps(buffer, analyzerFifosReadyForBlock);
+    return;
+  }
+
+  const auto numSamples = buffer.getNumSamples();
+  const auto inputIsSilent =
+    buffer.getMagnitude(0, numSamples) < silenceThreshold;
+
+  if (!inputIsSilent) {
+    numSilentSamples = 0;
+    isSleeping = false;
+  } else if (isSleeping) {
+    // the tails have died away and nothing is coming in
+    feedOutputTaps(buffer, analyzerFifosReadyForBlock);
+    return;
+  }
+
+  if (isTransparent) {
+    // coming back in. the output stays dry while the filters are primed from
+    // the recorded input, this block's included, and fades in from the next
+    // block once they have caught up
+    jumpToSettings(stereoSettings);
+    if (!warmingUp)
+      startWarmUp();
+
+    recordWarmUpHistory(buffer);
+    if (continueWarmUp(juce::jmax(warmUpSamplesPerBlock, 2 * numSamples)))
+      wetGain.setTargetValue(1.f);
+
+    feedOutputTaps(buffer, analyzerFifosReadyForBlock);
+    return;
+  }
+
+  if (switchingMode)
+    recordWarmUpHistory(buffer);
+
+  wetGain.setTargetValue(identity || switchingMode ? 0.f : 1.f);
+
+  // settings that leave the signal untouched fade the filters out instead.
+  // until they are silent they keep the last settings that weren't, or the
+  // wet path would already match the dry one and the change would be heard
+  // at once
+  if (!identity)
+    rampToSettings(stereoSettings);
 
   juce::dsp::AudioBlock<float> block(buffer);
 
+  if (!wetGain.isSmoothing()) {
+    processFiltered(block, redesignBudget);
+  } else {
+    // crossfade between the dry input and the filtered output
+    const auto numChannels =
+      juce::jmin(buffer.getNumChannels(), dryBuffer.getNumChannels());
+    const auto chunkSize = dryBuffer.getNumSamples();
+
+    for (int start = 0; start < numSamples; start += chunkSize) {
+      auto num = juce::jmin(chunkSize, numSamples - start);
+
+      for (int ch = 0; ch < numChannels; ++ch) {
+        dryBuffer.copyFrom(ch, 0, buffer, ch, start, num);
+      }
+
+      auto subBlock = block.getSubBlock((size_t)start, (size_t)num);
+      processFiltered(subBlock, redesignBudget);
+
+      for (int i = 0; i < num; ++i) {
+        fadeGains[i] = wetGain.getNextValue();
+      }
+
+      for (int ch = 0; ch < numChannels; ++ch) {
+        auto* out = buffer.getWritePointer(ch, start);
+        auto* dry = dryBuffer.getReadPointer(ch);
+
+        // out = dry + gain * (wet - dry)
+        juce::FloatVectorOperations::subtract(out, dry, num);
+        juce::FloatVectorOperations::multiply(out, fadeGains.data(), num);
+        juce::FloatVectorOperations::add(out, dry, num);
+      }
+    }
+  }
+
+  if (inputIsSilent && !wetGain.isSmoothing()) {
+    numSilentSamples += numSamples;
+
+    // once the input has been silent for longer than the tail, and both the
+    // output and what's left in the filters agree they have rung out, stop
+    // processing until signal returns
+    auto tailLengthSamples = tailLengthSeconds.load() * getSampleRate();
+    if (numSilentSamples >= tailLengthSamples &&
+        buffer.getMagnitude(0, numSamples) < silenceThreshold &&
+        getFilterStateMagnitude() < silenceThreshold) {
+      sleep();
+    }
+  }
+
+  feedOutputTaps(buffer, analyzerFifosReadyForBlock);
+}
+
+void
+SimpleEqAudioProcessor::feedOutputTaps(const juce::AudioBuffer<float>& buffer,
+                                       bool analyzerFifosReadyForBlock)
+{
+  if (analyzerFifosReadyForBlock) {
+    leftChannelFifo.update(buffer);
+    rightChannelFifo.update(buffer);
+  }
+}
+
+void
+SimpleEqAudioProcessor::updateAudioMorphSnapshots()
+{
+  auto version = morphSnapshotsVersion.load();
+  if (version == audioMorphSnapshotsVersion)
+    return;
+
+  // if the message thread is busy writing, keep morphing between the old
+  // snapshots and try again next block
+  const juce::SpinLock::ScopedTryLockType lock(morphLock);
+  if (lock.isLocked()) {
+    audioMorphSnapshots = morphSnapshots;
+    audioMorphSnapshotsVersion = version;
+  }
+}
+
+float
+getStateMagnitude(const Filter& filter)
+{
+  return juce::jmax(std::abs(filter.state.z1), std::abs(filter.state.z2));
+}
+
+float
+getStateMagnitude(const CutFilter& cutFilter)
+{
+  return juce::jmax(getStateMagnitude(cutFilter.get<0>()),
+                    getStateMagnitude(cutFilter.get<1>()),
+                    getStateMagnitude(cutFilter.get<2>()),
+                    getStateMagnitude(cutFilter.get<3>()));
+}
+
+float
+SimpleEqAudioProcessor::getFilterStateMagnitude() const
+{
+  // bypassed sections are included, they are cleared by sleep() all the same
+  auto magnitude = bandFilter.getStateMagnitude();
+  for (const auto* chain : { &leftChain, &rightChain }) {
+    magnitude =
+      juce::jmax(magnitude,
+                 getStateMagnitude(chain->get<ChainPositions::LowCut>()),
+                 getStateMagnitude(chain->get<ChainPositions::Peak>()),
+                 getStateMagnitude(chain->get<ChainPositions::HighCut>()));
+  }
+
+  return magnitude;
+}
+
+void
+SimpleEqAudioProcessor::sleep()
+{
+  // what's left in the filter states is below the silence threshold, clearing
+  // it means processing resumes from a clean state
+  leftChain.reset();
+  rightChain.reset();
+  bandFilter.reset();
+
+  isSleeping = true;
+}
+
+void
+SimpleEqAudioProcessor::updateAudioParameters()
+{
+  for (int set = 0; set < NumChainParameterSets; ++set) {
+    auto& snapshot = *parameterSnapshots[set];
+
+    // the editor publishes too, whichever gets there first does the work
+    snapshot.publish();
+
+    // if the editor is mid publish this block keeps the previous settings
+    if (snapshot.hasChangedSince(audioParameterVersions[set]))
+      snapshot.tryRead(audioParameters[set], audioParameterVersions[set]);
+  }
+}
+
+StereoChainSettings
+SimpleEqAudioProcessor::makeStereoChainSettings(
+  const ChainSettings& main,
+  const ParameterSetSettings& parameters,
+  bool midSide,
+  bool linked)
+{
+  // the extra bands are shared, only the fixed bands differ between mid and
+  // side, or left and right
+  StereoChainSettings stereoSettings{ main, main };
+  if (midSide || !linked) {
+    stereoSettings[1] = parameters[midSide ? SideParameters : RightParameters];
+    stereoSettings[1].bands = main.bands;
+  }
+
+  return stereoSettings;
+}
+
+bool
+SimpleEqAudioProcessor::isLinked() const
+{
+  return channelLink->load() > 0.5f || rightSetPending.load();
+}
+
+void
+SimpleEqAudioProcessor::setChannelsLinked(bool shouldBeLinked)
+{
+  auto* link = apvts.getParameter("Channel Link");
+  const auto wasLinked = channelLink->load() > 0.5f;
+
+  // the audio thread keeps the channels linked until the copy is in, so it
+  // never runs a block with the link off and the old Right set
+  if (wasLinked && !shouldBeLinked) {
+    rightSetPending.store(true);
+    setChainSettings(apvts, getChainSettings(apvts), RightParameters);
+  }
+
+  link->beginChangeGesture();
+  link->setValueNotifyingHost(shouldBeLinked ? 1.f : 0.f);
+  link->endChangeGesture();
+
+  rightSetPending.store(false);
+}
+
+void
+SimpleEqAudioProcessor::renderOffline(const juce::AudioBuffer<float>& input,
+                                      juce::AudioBuffer<float>& output,
+                                      juce::ThreadPool& pool)
+{
+  const auto linked = isLinked();
+
+  ParameterSetSettings parameters;
+  for (int set = 0; set < NumChainParameterSets; ++set)
+    parameterSnapshots[set]->read(parameters[set]);
+
+  auto chainSettings = parameters[MainParameters];
+  if (morphEnabled->load() > 0.5f) {
+    chainSettings = morphChainSettings(
+      getMorphSnapshot(0), getMorphSnapshot(1), morphAmount->load());
+  }
+
+  OfflineRenderSettings settings;
+  settings.midSide = stereoMode->load() > 0.5f;
+  settings.chainSettings = makeStereoChainSettings(
+    chainSettings, parameters, settings.midSide, linked);
+  settings.sampleRate = getSampleRate() > 0 ? getSampleRate() : 44100.0;
+
+  OfflineRenderer::render(settings, input, output, pool);
+}
+
+void
+saveSection(const Filter& filter,
+            bool bypassed,
+            DSPStateSnapshot::Section& section)
+{
+  const auto* c = filter.coefficients->getRawCoefficients();
+  std::copy(c, c + 5, section.coefficients.begin());
+  section.state = filter.state;
+  section.bypassed = bypassed;
+}
+
+void
+restoreSection(Filter& filter, const DSPStateSnapshot::Section& section)
+{
+  auto* c = getBiquadCoefficients(filter);
+  std::copy(section.coefficients.begin(), section.coefficients.end(), c);
+  filter.state = section.state;
+}
+
+template<typename ChainType, typename Sections>
+void
+saveCutFilter(const ChainType& chain, Sections& sections)
+{
+  saveSection(
+    chain.template get<0>(), chain.template isBypassed<0>(), sections[0]);
+  saveSection(
+    chain.template get<1>(), chain.template isBypassed<1>(), sections[1]);
+  saveSection(
+    chain.template get<2>(), chain.template isBypassed<2>(), sections[2]);
+  saveSection(
+    chain.template get<3>(), chain.template isBypassed<3>(), sections[3]);
+}
+
+template<typename ChainType, typename Sections>
+void
+restoreCutFilter(ChainType& chain, const Sections& sections)
+{
+  restoreSection(chain.template get<0>(), sections[0]);
+  restoreSection(chain.template get<1>(), sections[1]);
+  restoreSection(chain.template get<2>(), sections[2]);
+  restoreSection(chain.template get<3>(), sections[3]);
+
+  chain.template setBypassed<0>(sections[0].bypassed);
+  chain.template setBypassed<1>(sections[1].bypassed);
+  chain.template setBypassed<2>(sections[2].bypassed);
+  chain.template setBypassed<3>(sections[3].bypassed);
+}
+
+void
+SimpleEqAudioProcessor::getDSPState(DSPStateSnapshot& snapshot) const
+{
+  snapshot.sampleRate = getSampleRate();
+
+  const MonoChain* chains[] = { &leftChain, &rightChain };
+  for (int ch = 0; ch < 2; ++ch) {
+    const auto& chain = *chains[ch];
+    auto& saved = snapshot.chains[ch];
+
+    saveCutFilter(chain.get<ChainPositions::LowCut>(), saved.lowCut);
+    saveCutFilter(chain.get<ChainPositions::HighCut>(), saved.highCut);
+    saveSection(chain.get<ChainPositions::Peak>(),
+                chain.isBypassed<ChainPositions::Peak>(),
+                saved.peak);
+
+    saved.lowCutBypassed = chain.isBypassed<ChainPositions::LowCut>();
+    saved.highCutBypassed = chain.isBypassed<ChainPositions::HighCut>();
+  }
+
+  bandFilter.getState(snapshot.bandFilter);
+
+  snapshot.appliedSettings = appliedSettings;
+  snapshot.currentSettings = currentSettings;
+  snapshot.rampStart = rampStart;
+  snapshot.rampTarget = rampTarget;
+  snapshot.rampPosition = rampPosition;
+  snapshot.rampLength = rampLength;
+  snapshot.nextBandToRedesign = nextBandToRedesign;
+
+  snapshot.wetGain = wetGain.getCurrentValue();
+  snapshot.wetGainTarget = wetGain.getTargetValue();
+  snapshot.numSilentSamples = numSilentSamples;
+  snapshot.isSleeping = isSleeping;
+
+  snapshot.processMidSide = processMidSide;
+  snapshot.stereoModeMidSide = stereoMode->load() > 0.5f;
+}
+
+bool
+SimpleEqAudioProcessor::setDSPState(const DSPStateSnapshot& snapshot)
+{
+  // the coefficients are only valid at the rate they were designed for, and
+  // in another Stereo Mode the next block would start switching modes
+  if (snapshot.sampleRate != getSampleRate() ||
+      snapshot.stereoModeMidSide != (stereoMode->load() > 0.5f))
+    return false;
+
+  MonoChain* chains[] = { &leftChain, &rightChain };
+  for (int ch = 0; ch < 2; ++ch) {
+    auto& chain = *chains[ch];
+    const auto& saved = snapshot.chains[ch];
+
+    restoreCutFilter(chain.get<ChainPositions::LowCut>(), saved.lowCut);
+    restoreCutFilter(chain.get<ChainPositions::HighCut>(), saved.highCut);
+    restoreSection(chain.get<ChainPositions::Peak>(), saved.peak);
+
+    chain.setBypassed<ChainPositions::LowCut>(saved.lowCutBypassed);
+    chain.setBypassed<ChainPositions::Peak>(saved.peak.bypassed);
+    chain.setBypassed<ChainPositions::HighCut>(saved.highCutBypassed);
+  }
+
+  bandFilter.setState(snapshot.bandFilter);
+
+  // the filters now match the snapshot's settings, so only what has changed
+  // since then is redesigned
+  appliedSettings = snapshot.appliedSettings;
+  appliedSettingsValid = true;
+  currentSettings = snapshot.currentSettings;
+  rampStart = snapshot.rampStart;
+  rampTarget = snapshot.rampTarget;
+  rampPosition = snapshot.rampPosition;
+  rampLength = snapshot.rampLength;
+  nextBandToRedesign = snapshot.nextBandToRedesign;
+
+  wetGain.setCurrentAndTargetValue(snapshot.wetGain);
+  wetGain.setTargetValue(snapshot.wetGainTarget);
+  numSilentSamples = snapshot.numSilentSamples;
+  isSleeping = snapshot.isSleeping;
+
+  processMidSide = snapshot.processMidSide;
+
+  // the recorded input belongs to the stream the processor left
+  warmingUp = false;
+  warmUpBuffer.clear();
+  warmUpWriteIndex = warmUpReadIndex = 0;
+  numWarmUpSamplesPending = 0;
+
+  return true;
+}
+
+void
+SimpleEqAudioProcessor::jumpToSettings(const StereoChainSettings& chainSettings)
+{
+  rampStart = rampTarget = currentSettings = chainSettings;
+  rampPosition = rampLength = rampLengthSamples;
+
+  updateFilters(currentSettings);
+}
+
+void
+SimpleEqAudioProcessor::rampToSettings(const StereoChainSettings& chainSettings)
+{
+  if (chainSettings == rampTarget)
+    return;
+
+  // a change that arrives mid ramp heads for the new target from where the
+  // filters are now, but keeps the old end point. automation that moves on
+  // every block would otherwise restart the ramp forever and never catch up
+  const auto rampRunning = rampPosition < rampLength;
+  rampLength = rampRunning ? juce::jmax(rampLength - rampPosition,
+                                        automationSubBlockSize)
+                           : rampLengthSamples;
+
+  rampStart = currentSettings;
+  rampTarget = chainSettings;
+  rampPosition = 0;
+
+  // only the continuous values ramp, switches take effect straight away
+  for (int ch = 0; ch < 2; ++ch) {
+    auto& start = rampStart[ch];
+    const auto& target = rampTarget[ch];
+
+    start.lowCutSlope = target.lowCutSlope;
+    start.highCutSlope = target.highCutSlope;
+    start.lowCutBypassed = target.lowCutBypassed;
+    start.peakBypassed = target.peakBypassed;
+    start.highCutBypassed = target.highCutBypassed;
+
+    for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+      start.bands[i].type = target.bands[i].type;
+      start.bands[i].bypassed = target.bands[i].bypassed;
+    }
+  }
+}
+
+void
+SimpleEqAudioProcessor::processFiltered(juce::dsp::AudioBlock<float>& block,
+                                        int& redesignBudget)
+{
+  const auto numSamples = (int)block.getNumSamples();
+
+  for (int start = 0; start < numSamples;) {
+    auto num = numSamples - start;
+
+    // while a ramp is running the block is split into short sub-blocks, and
+    // the filters follow the ramp from one sub-block to the next
+    if (rampPosition < rampLength) {
+      num = juce::jmin(num, automationSubBlockSize);
+      rampPosition = juce::jmin(rampPosition + num, rampLength);
+
+      auto amount = rampPosition / float(rampLength);
+      for (int ch = 0; ch < 2; ++ch) {
+        currentSettings[ch] =
+          morphChainSettings(rampStart[ch], rampTarget[ch], amount);
+      }
+    }
+
+    // only the bands that moved get redesigned, and the budget runs out for
+    // the whole block rather than for each sub-block
+    redesignBudget -= updateFilters(currentSettings, redesignBudget);
+
+    auto subBlock = block.getSubBlock((size_t)start, (size_t)num);
+    processChains(subBlock);
+
+    start += num;
+  }
+}
+
+void
+SimpleEqAudioProcessor::processChains(juce::dsp::AudioBlock<float>& block)
+{
+  processStereoChains(leftChain, rightChain, bandFilter, block, processMidSide);
+}
+
+void
+processChainsInPlace(MonoChain& leftChain,
+                     MonoChain& rightChain,
+                     MultiBandFilter& bandFilter,
+                     juce::dsp::AudioBlock<float>& block)
+{
   auto leftBlock = block.getSingleChannelBlock(0);
   auto rightBlock = block.getSingleChannelBlock(1);
 
@@ -191,21 +897,143 @@ SimpleEqAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
   leftChain.process(leftContext);
   rightChain.process(rightContext);
 
-  leftChannelFifo.update(buffer);
-  rightChannelFifo.update(buffer);
+  bandFilter.process(block);
+}
+
+void
+processStereoChains(MonoChain& leftChain,
+                    MonoChain& rightChain,
+                    MultiBandFilter& bandFilter,
+                    juce::dsp::AudioBlock<float>& block,
+                    bool midSide)
+{
+  // samples encoded to Mid/Side at a time, small enough to stay in cache
+  constexpr size_t midSideChunkSize = 64;
+
+  const auto numSamples = block.getNumSamples();
+  if (numSamples == 0)
+    return;
+
+  if (!midSide) {
+    processChainsInPlace(leftChain, rightChain, bandFilter, block);
+    return;
+  }
+
+  // encode, filter and decode a short chunk at a time. the chunk stays in
+  // cache throughout, so the Mid/Side conversion costs no extra passes over
+  // the block
+  for (size_t start = 0; start < numSamples; start += midSideChunkSize) {
+    auto num = juce::jmin(midSideChunkSize, numSamples - start);
+    auto chunk = block.getSubBlock(start, num);
+
+    auto* left = chunk.getChannelPointer(0);
+    auto* right = chunk.getChannelPointer(1);
+
+    for (size_t i = 0; i < num; ++i) {
+      auto mid = 0.5f * (left[i] + right[i]);
+      auto side = 0.5f * (left[i] - right[i]);
+      left[i] = mid;
+      right[i] = side;
+    }
+
+    processChainsInPlace(leftChain, rightChain, bandFilter, chunk);
+
+    for (size_t i = 0; i < num; ++i) {
+      auto mid = left[i];
+      auto side = right[i];
+      left[i] = mid + side;
+      right[i] = mid - side;
+    }
+  }
+}
+
+void
+SimpleEqAudioProcessor::recordWarmUpHistory(
+  const juce::AudioBuffer<float>& buffer)
+{
+  const auto historySize = warmUpBuffer.getNumSamples();
+  const auto numChannels =
+    juce::jmin(buffer.getNumChannels(), warmUpBuffer.getNumChannels());
+
+  // only the most recent historySize samples matter
+  auto numSamples = juce::jmin(buffer.getNumSamples(), historySize);
+  auto readIndex = buffer.getNumSamples() - numSamples;
+
+  // the new samples join the backlog still to be replayed. if it outgrows
+  // the history the oldest of it is lost
+  if (warmingUp) {
+    numWarmUpSamplesPending =
+      juce::jmin(numWarmUpSamplesPending + numSamples, historySize);
+  }
+
+  while (numSamples > 0) {
+    auto num = juce::jmin(numSamples, historySize - warmUpWriteIndex);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      warmUpBuffer.copyFrom(ch, warmUpWriteIndex, buffer, ch, readIndex, num);
+    }
+
+    warmUpWriteIndex = (warmUpWriteIndex + num) % historySize;
+    readIndex += num;
+    numSamples -= num;
+  }
+
+  if (warmingUp) {
+    warmUpReadIndex =
+      (warmUpWriteIndex - numWarmUpSamplesPending + historySize) % historySize;
+  }
+}
+
+void
+SimpleEqAudioProcessor::startWarmUp()
+{
+  leftChain.reset();
+  rightChain.reset();
+  bandFilter.reset();
+
+  // the filters only remember as far back as their tail, so that's all the
+  // history that needs replaying. tails longer than the history are primed
+  // from the last maxWarmUpSeconds only, and whatever they would still be
+  // ringing from before that is missing when they are heard again
+  const auto historySize = warmUpBuffer.getNumSamples();
+  const auto tailSamples =
+    std::ceil(tailLengthSeconds.load() * getSampleRate());
+
+  warmingUp = true;
+  numWarmUpSamplesPending =
+    (int)juce::jlimit(0.0, (double)historySize, tailSamples);
+  warmUpReadIndex =
+    (warmUpWriteIndex - numWarmUpSamplesPending + historySize) % historySize;
+}
+
+bool
+SimpleEqAudioProcessor::continueWarmUp(int maxSamples)
+{
+  jassert(warmingUp);
+  const auto historySize = warmUpBuffer.getNumSamples();
+
+  // run the history through the filters, oldest samples first. it is
+  // processed in place, each sample is only replayed once
+  juce::dsp::AudioBlock<float> history(warmUpBuffer);
+  auto remaining = juce::jmin(maxSamples, numWarmUpSamplesPending);
+
+  while (remaining > 0) {
+    auto num = juce::jmin(remaining, historySize - warmUpReadIndex);
+    auto older = history.getSubBlock((size_t)warmUpReadIndex, (size_t)num);
+    processChains(older);
+
+    warmUpReadIndex = (warmUpReadIndex + num) % historySize;
+    numWarmUpSamplesPending -= num;
+    remaining -= num;
+  }
 
-  //    // This is the place where you'd normally do the guts of your plugin's
-  //    // audio processing...
-  //    // Make sure to reset the state if your inner loop is processing
-  //    // the samples and the outer loop is handling the channels.
-  //    // Alternatively, you can process the samples with the channels
-  //    // interleaved by keeping the same state.
-  //    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-  //    {
-  ////        auto* channelData = buffer.getWritePointer (channel);
-  //
-  //        // ..do something to the data...
-  //    }
+  if (numWarmUpSamplesPending > 0)
+    return false;
+
+  warmingUp = false;
+  warmUpBuffer.clear();
+  warmUpWriteIndex = warmUpReadIndex = 0;
+  return true;
 }
 
 //==============================================================================
@@ -223,14 +1051,95 @@ SimpleEqAudioProcessor::createEditor()
 }
 
 //==============================================================================
+/* The state is a fixed header followed by one normalised float per parameter,
+   in the order they were added to the layout, all little-endian. A state
+   whose layout hash matches this build is restored by index. Since version 5
+   the parameter IDs follow at the end, so one saved with a different layout
+   is restored by ID instead, and anything a state doesn't cover is reset to
+   its default.
+*/
+struct StateHeader
+{
+  static constexpr juce::uint32 expectedMagic = 0x42514553; // "SEQB"
+  static constexpr juce::uint32 currentVersion = 5;
+
+  juce::uint32 magic, version, numParameters;
+
+  // version 3 onwards, see getParameterLayoutHash
+  juce::uint32 parameterLayoutHash;
+};
+
+// version 2 adds the two morph snapshots as PresetRecords after the values,
+// version 4 the MemoryBudget as a uint32 after those, and version 5 the
+// parameter IDs as null terminated UTF-8 strings. the budget isn't a
+// parameter, it is a setting of the instance that hosts mustn't automate
+
+juce::uint32
+SimpleEqAudioProcessor::getParameterLayoutHash(int numParameters) const
+{
+  jassert(juce::isPositiveAndNotGreaterThan(numParameters,
+                                            getParameters().size()));
+  return parameterLayoutHashes[(size_t)numParameters];
+}
+
+static juce::String
+getParameterID(juce::AudioProcessorParameter* param)
+{
+  if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param))
+    return withID->paramID;
+
+  return {};
+}
+
+void
+SimpleEqAudioProcessor::updateParameterLayoutHashes()
+{
+  // FNV-1a over the IDs in layout order. entry n covers the first n IDs, so a
+  // state saved before parameters were appended can still be checked
+  const auto& params = getParameters();
+  parameterLayoutHashes.resize((size_t)params.size() + 1);
+
+  juce::uint32 hash = 2166136261u;
+  parameterLayoutHashes[0] = hash;
+
+  for (int i = 0; i < params.size(); ++i) {
+    const auto id = getParameterID(params[i]);
+
+    for (auto* c = id.toRawUTF8(); *c != 0; ++c)
+      hash = (hash ^ (juce::uint8)*c) * 16777619u;
+
+    // the terminator keeps "ab", "c" apart from "a", "bc"
+    hash *= 16777619u;
+    parameterLayoutHashes[(size_t)i + 1] = hash;
+  }
+}
+
 void
 SimpleEqAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
   // You should use this method to store your parameters in the memory block.
   // You could do that either as raw data, or use the XML or ValueTree classes
   // as intermediaries to make it easy to save and load complex data.
-  juce::MemoryOutputStream mos(destData, true);
-  apvts.state.writeToStream(mos);
+  const auto& params = getParameters();
+
+  destData.reset();
+  juce::MemoryOutputStream stream(destData, false);
+
+  stream.writeInt((int)StateHeader::expectedMagic);
+  stream.writeInt((int)StateHeader::currentVersion);
+  stream.writeInt(params.size());
+  stream.writeInt((int)getParameterLayoutHash(params.size()));
+
+  for (auto* param : params)
+    stream.writeFloat(param->getValue());
+
+  for (int slot = 0; slot < 2; ++slot)
+    writePresetRecord(stream, makePresetRecord(getMorphSnapshot(slot), {}));
+
+  stream.writeInt((int)memoryBudget);
+
+  for (auto* param : params)
+    stream.writeString(getParameterID(param));
 }
 
 void
@@ -239,139 +1148,740 @@ SimpleEqAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
   // You should use this method to restore your parameters from this memory
   // block, whose contents will have been created by the getStateInformation()
   // call.
-  auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-  if (tree.isValid()) {
-    apvts.replaceState(tree);
-    updateFilters();
+  // The filters pick the new values up on the next block.
+  if (!setBinaryState(data, sizeInBytes)) {
+    // states saved before the binary format were a whole ValueTree
+    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
+    if (tree.isValid()) {
+      apvts.replaceState(tree);
+    }
   }
 }
 
+bool
+SimpleEqAudioProcessor::setBinaryState(const void* data, int sizeInBytes)
+{
+  juce::MemoryInputStream stream(
+    data, (size_t)juce::jmax(0, sizeInBytes), false);
+
+  StateHeader header{};
+  if (stream.getNumBytesRemaining() < 3 * (juce::int64)sizeof(juce::uint32))
+    return false;
+
+  header.magic = (juce::uint32)stream.readInt();
+  if (header.magic != StateHeader::expectedMagic)
+    return false;
+
+  header.version = (juce::uint32)stream.readInt();
+  header.numParameters = (juce::uint32)stream.readInt();
+
+  // written by a newer build. it is ours, but there's no telling what it
+  // holds, so the current settings are kept
+  if (header.version > StateHeader::currentVersion)
+    return true;
+
+  if (header.version >= 3) {
+    if (stream.getNumBytesRemaining() < (juce::int64)sizeof(juce::uint32))
+      return false;
+
+    header.parameterLayoutHash = (juce::uint32)stream.readInt();
+  }
+
+  const auto numSaved = (juce::int64)header.numParameters;
+  if (stream.getNumBytesRemaining() < numSaved * (juce::int64)sizeof(float))
+    return false;
+
+  std::vector<float> saved((size_t)numSaved);
+  for (auto& value : saved)
+    value = stream.readFloat();
+
+  std::array<PresetRecord, 2> snapshots;
+  auto hasSnapshots = header.version >= 2;
+  for (auto& record : snapshots)
+    hasSnapshots = hasSnapshots && readPresetRecord(stream, record);
+
+  // states without one keep the budget the instance already has
+  auto hasBudget = hasSnapshots && header.version >= 4 &&
+                   stream.getNumBytesRemaining() >=
+                     (juce::int64)sizeof(juce::uint32);
+  const auto budget = hasBudget ? (juce::uint32)stream.readInt() : 0u;
+
+  // where each saved value goes, -1 for one this build has no parameter for
+  const auto& params = getParameters();
+  std::vector<int> indices((size_t)numSaved, -1);
+
+  if (header.version < 3 ||
+      (numSaved <= params.size() &&
+       header.parameterLayoutHash == getParameterLayoutHash((int)numSaved))) {
+    for (int i = 0; i < (int)numSaved && i < params.size(); ++i)
+      indices[(size_t)i] = i;
+  } else if (header.version >= 5 && hasBudget) {
+    // the layout changed since the state was saved, so each value is matched
+    // to its parameter by ID. renamed or removed ones are dropped
+    for (auto& index : indices) {
+      if (stream.isExhausted())
+        break;
+
+      if (auto* param = apvts.getParameter(stream.readString()))
+        index = param->getParameterIndex();
+    }
+  }
+
+  // anything the state doesn't cover goes back to its default, and so does
+  // every parameter of an older state whose layout doesn't match
+  std::vector<float> values((size_t)params.size());
+  for (int i = 0; i < params.size(); ++i)
+    values[(size_t)i] = params[i]->getDefaultValue();
+
+  for (size_t i = 0; i < saved.size(); ++i) {
+    // a damaged value leaves the parameter at its default
+    if (indices[i] >= 0 && std::isfinite(saved[i]))
+      values[(size_t)indices[i]] = juce::jlimit(0.f, 1.f, saved[i]);
+  }
+
+  for (int i = 0; i < params.size(); ++i) {
+    if (params[i]->getValue() != values[(size_t)i])
+      params[i]->setValueNotifyingHost(values[(size_t)i]);
+  }
+
+  if (hasSnapshots) {
+    for (int slot = 0; slot < 2; ++slot)
+      setMorphSnapshot(slot, getChainSettings(snapshots[(size_t)slot]));
+  }
+
+  if (hasBudget && budget <= MemoryBudget_Compact)
+    setMemoryBudget(static_cast<MemoryBudget>(budget));
+
+  return true;
+}
+
+//==============================================================================
+bool
+SimpleEqAudioProcessor::loadPresetLibrary(const juce::File& file)
+{
+  return presetLibrary.open(file);
+}
+
+void
+SimpleEqAudioProcessor::recallPreset(int index)
+{
+  if (juce::isPositiveAndBelow(index, presetLibrary.getNumPresets())) {
+    setChainSettings(apvts, presetLibrary.getSettings(index));
+  }
+}
+
+void
+SimpleEqAudioProcessor::setMorphSnapshot(int slot,
+                                         const ChainSettings& chainSettings)
+{
+  jassert(slot == 0 || slot == 1);
+
+  const juce::SpinLock::ScopedLockType lock(morphLock);
+  morphSnapshots[slot] = chainSettings;
+  ++morphSnapshotsVersion;
+}
+
 ChainSettings
-getChainSettings(juce::AudioProcessorValueTreeState& apvts)
+SimpleEqAudioProcessor::getMorphSnapshot(int slot) const
 {
-  ChainSettings settings;
+  jassert(slot == 0 || slot == 1);
+
+  const juce::SpinLock::ScopedLockType lock(morphLock);
+  return morphSnapshots[slot];
+}
 
-  settings.lowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
-  settings.highCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
-  settings.peakFreq = apvts.getRawParameterValue("Peak Freq")->load();
-  settings.peakGainInDecibles = apvts.getRawParameterValue("Peak Gain")->load();
-  settings.peakQuality = apvts.getRawParameterValue("Peak Quality")->load();
+ChainSettings
+getChainSettings(juce::AudioProcessorValueTreeState& apvts,
+                 ChainParameterSet set)
+{
+  ChainSettings settings;
+  const auto& ids = getChainParameterIDs(set);
+
+  settings.lowCutFreq = apvts.getRawParameterValue(ids.lowCutFreq)->load();
+  settings.highCutFreq = apvts.getRawParameterValue(ids.highCutFreq)->load();
+  settings.peakFreq = apvts.getRawParameterValue(ids.peakFreq)->load();
+  settings.peakGainInDecibles =
+    apvts.getRawParameterValue(ids.peakGain)->load();
+  settings.peakQuality = apvts.getRawParameterValue(ids.peakQuality)->load();
   settings.lowCutSlope =
-    static_cast<Slope>(apvts.getRawParameterValue("LowCut Slope")->load());
+    static_cast<Slope>(apvts.getRawParameterValue(ids.lowCutSlope)->load());
   settings.highCutSlope =
-    static_cast<Slope>(apvts.getRawParameterValue("HighCut Slope")->load());
+    static_cast<Slope>(apvts.getRawParameterValue(ids.highCutSlope)->load());
 
   settings.lowCutBypassed =
-    apvts.getRawParameterValue("LowCut Bypassed")->load() > 0.5f;
+    apvts.getRawParameterValue(ids.lowCutBypassed)->load() > 0.5f;
   settings.peakBypassed =
-    apvts.getRawParameterValue("Peak Bypassed")->load() > 0.5f;
+    apvts.getRawParameterValue(ids.peakBypassed)->load() > 0.5f;
   settings.highCutBypassed =
-    apvts.getRawParameterValue("HighCut Bypassed")->load() > 0.5f;
+    apvts.getRawParameterValue(ids.highCutBypassed)->load() > 0.5f;
+
+  const auto& bandIDs = getBandParameterIDs();
+  for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+    auto& band = settings.bands[i];
+    band.type =
+      static_cast<BandType>(apvts.getRawParameterValue(bandIDs[i].type)->load());
+    band.freq = apvts.getRawParameterValue(bandIDs[i].freq)->load();
+    band.gainInDecibels = apvts.getRawParameterValue(bandIDs[i].gain)->load();
+    band.quality = apvts.getRawParameterValue(bandIDs[i].quality)->load();
+    band.bypassed =
+      apvts.getRawParameterValue(bandIDs[i].bypassed)->load() > 0.5f;
+  }
   return settings;
 }
 
-Coefficients
-makePeakFilter(const ChainSettings& chainSettings, double sampleRate)
+void
+setChainSettings(juce::AudioProcessorValueTreeState& apvts,
+                 const ChainSettings& chainSettings,
+                 ChainParameterSet set)
 {
-  return juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-    sampleRate,
-    chainSettings.peakFreq,
-    chainSettings.peakQuality,
-    juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibles));
+  auto setParameter = [&apvts](const juce::String& parameterID, float value) {
+    if (auto* param = apvts.getParameter(parameterID)) {
+      param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+  };
+
+  const auto& ids = getChainParameterIDs(set);
+  setParameter(ids.lowCutFreq, chainSettings.lowCutFreq);
+  setParameter(ids.highCutFreq, chainSettings.highCutFreq);
+  setParameter(ids.peakFreq, chainSettings.peakFreq);
+  setParameter(ids.peakGain, chainSettings.peakGainInDecibles);
+  setParameter(ids.peakQuality, chainSettings.peakQuality);
+  setParameter(ids.lowCutSlope, (float)chainSettings.lowCutSlope);
+  setParameter(ids.highCutSlope, (float)chainSettings.highCutSlope);
+  setParameter(ids.lowCutBypassed, chainSettings.lowCutBypassed ? 1.f : 0.f);
+  setParameter(ids.peakBypassed, chainSettings.peakBypassed ? 1.f : 0.f);
+  setParameter(ids.highCutBypassed, chainSettings.highCutBypassed ? 1.f : 0.f);
+
+  if (set != MainParameters)
+    return;
+
+  const auto& bandIDs = getBandParameterIDs();
+  for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+    const auto& band = chainSettings.bands[i];
+    setParameter(bandIDs[i].type, (float)band.type);
+    setParameter(bandIDs[i].freq, band.freq);
+    setParameter(bandIDs[i].gain, band.gainInDecibels);
+    setParameter(bandIDs[i].quality, band.quality);
+    setParameter(bandIDs[i].bypassed, band.bypassed ? 1.f : 0.f);
+  }
 }
 
-void
-SimpleEqAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings)
+ChainSettings
+morphChainSettings(const ChainSettings& a, const ChainSettings& b, float amount)
+{
+  auto linear = [amount](float from, float to) {
+    return from + (to - from) * amount;
+  };
+  auto logarithmic = [amount, linear](float from, float to) {
+    if (from <= 0.f || to <= 0.f)
+      return linear(from, to);
+
+    return from * std::pow(to / from, amount);
+  };
+  auto choose = [amount](auto from, auto to) {
+    return amount < 0.5f ? from : to;
+  };
+
+  ChainSettings settings;
+
+  settings.peakFreq = logarithmic(a.peakFreq, b.peakFreq);
+  settings.peakGainInDecibles =
+    linear(a.peakGainInDecibles, b.peakGainInDecibles);
+  settings.peakQuality = logarithmic(a.peakQuality, b.peakQuality);
+  settings.lowCutFreq = logarithmic(a.lowCutFreq, b.lowCutFreq);
+  settings.highCutFreq = logarithmic(a.highCutFreq, b.highCutFreq);
+  settings.lowCutSlope = choose(a.lowCutSlope, b.lowCutSlope);
+  settings.highCutSlope = choose(a.highCutSlope, b.highCutSlope);
+  settings.lowCutBypassed = choose(a.lowCutBypassed, b.lowCutBypassed);
+  settings.peakBypassed = choose(a.peakBypassed, b.peakBypassed);
+  settings.highCutBypassed = choose(a.highCutBypassed, b.highCutBypassed);
+
+  for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+    const auto& from = a.bands[i];
+    const auto& to = b.bands[i];
+    auto& band = settings.bands[i];
+
+    band.type = choose(from.type, to.type);
+    band.freq = logarithmic(from.freq, to.freq);
+    band.gainInDecibels = linear(from.gainInDecibels, to.gainInDecibels);
+    band.quality = logarithmic(from.quality, to.quality);
+    band.bypassed = choose(from.bypassed, to.bypassed);
+  }
+
+  return settings;
+}
+
+bool
+lowCutSettingsMatch(const ChainSettings& lhs, const ChainSettings& rhs)
+{
+  return lhs.lowCutFreq == rhs.lowCutFreq &&
+         lhs.lowCutSlope == rhs.lowCutSlope &&
+         lhs.lowCutBypassed == rhs.lowCutBypassed;
+}
+
+bool
+peakSettingsMatch(const ChainSettings& lhs, const ChainSettings& rhs)
+{
+  return lhs.peakFreq == rhs.peakFreq &&
+         lhs.peakGainInDecibles == rhs.peakGainInDecibles &&
+         lhs.peakQuality == rhs.peakQuality &&
+         lhs.peakBypassed == rhs.peakBypassed;
+}
+
+bool
+highCutSettingsMatch(const ChainSettings& lhs, const ChainSettings& rhs)
+{
+  return lhs.highCutFreq == rhs.highCutFreq &&
+         lhs.highCutSlope == rhs.highCutSlope &&
+         lhs.highCutBypassed == rhs.highCutBypassed;
+}
+
+bool
+operator==(const ChainSettings& lhs, const ChainSettings& rhs)
+{
+  return lowCutSettingsMatch(lhs, rhs) && peakSettingsMatch(lhs, rhs) &&
+         highCutSettingsMatch(lhs, rhs) && lhs.bands == rhs.bands;
+}
+
+bool
+operator!=(const ChainSettings& lhs, const ChainSettings& rhs)
+{
+  return !(lhs == rhs);
+}
+
+bool
+isIdentity(const ChainSettings& chainSettings)
+{
+  if (!chainSettings.lowCutBypassed || !chainSettings.highCutBypassed)
+    return false;
+
+  if (!chainSettings.peakBypassed && chainSettings.peakGainInDecibles != 0.f)
+    return false;
+
+  for (const auto& band : chainSettings.bands) {
+    if (band.bypassed)
+      continue;
+
+    // peaks and shelves without gain are flat, every other type isn't
+    auto hasGain = band.type == BandType_Peak ||
+                   band.type == BandType_LowShelf ||
+                   band.type == BandType_HighShelf;
+    if (!hasGain || band.gainInDecibels != 0.f)
+      return false;
+  }
+
+  return true;
+}
+
+double
+getTailLengthSeconds(const ChainSettings& chainSettings, double decayGain)
+{
+  double tail = 0.0;
+
+  if (!chainSettings.lowCutBypassed) {
+    tail = juce::jmax(tail,
+                      getCutFilterDecaySeconds(chainSettings.lowCutFreq,
+                                               chainSettings.lowCutSlope,
+                                               decayGain));
+  }
+
+  if (!chainSettings.highCutBypassed) {
+    tail = juce::jmax(tail,
+                      getCutFilterDecaySeconds(chainSettings.highCutFreq,
+                                               chainSettings.highCutSlope,
+                                               decayGain));
+  }
+
+  // a peak's poles sit at Q * sqrt(gain), so boosts ring longer than cuts
+  auto getPeakQ = [](float quality, float gainInDecibels) {
+    return quality * std::sqrt(juce::Decibels::decibelsToGain(gainInDecibels));
+  };
+
+  if (!chainSettings.peakBypassed) {
+    tail = juce::jmax(
+      tail,
+      getSectionDecaySeconds(
+        chainSettings.peakFreq,
+        getPeakQ(chainSettings.peakQuality, chainSettings.peakGainInDecibles),
+        decayGain));
+  }
+
+  for (const auto& band : chainSettings.bands) {
+    if (band.bypassed)
+      continue;
+
+    auto q = band.type == BandType_Peak
+               ? getPeakQ(band.quality, band.gainInDecibels)
+               : band.quality;
+    tail =
+      juce::jmax(tail, getSectionDecaySeconds(band.freq, q, decayGain));
+  }
+
+  return tail;
+}
+
+const ChainParameterIDs&
+getChainParameterIDs(ChainParameterSet set)
+{
+  static const auto ids = [] {
+    std::array<ChainParameterIDs, NumChainParameterSets> result;
+    const char* prefixes[] = { "", "Side ", "Right " };
+    for (int i = 0; i < NumChainParameterSets; ++i) {
+      juce::String prefix(prefixes[i]);
+      result[i] = { prefix + "LowCut Freq",     prefix + "HighCut Freq",
+                    prefix + "Peak Freq",       prefix + "Peak Gain",
+                    prefix + "Peak Quality",    prefix + "LowCut Slope",
+                    prefix + "HighCut Slope",   prefix + "LowCut Bypassed",
+                    prefix + "Peak Bypassed",   prefix + "HighCut Bypassed" };
+    }
+    return result;
+  }();
+
+  return ids[set];
+}
+
+const std::array<BandParameterIDs, MultiBandFilter::MaxBands>&
+getBandParameterIDs()
 {
-  auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
+  static const auto ids = [] {
+    std::array<BandParameterIDs, MultiBandFilter::MaxBands> result;
+    for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+      juce::String prefix;
+      prefix << "Band " << (i + 1) << " ";
+      result[i] = { prefix + "Type",
+                    prefix + "Freq",
+                    prefix + "Gain",
+                    prefix + "Quality",
+                    prefix + "Bypassed" };
+    }
+    return result;
+  }();
+
+  return ids;
+}
 
-  leftChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
-  rightChain.setBypassed<ChainPositions::Peak>(chainSettings.peakBypassed);
+juce::NormalisableRange<float>
+getFrequencyRange()
+{
+  return { 20.f, 20000.f, 1.f, 0.25f };
+}
+
+juce::NormalisableRange<float>
+getGainRange()
+{
+  return { -24.f, 24.f, 0.5f, 1.f };
+}
 
-  updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients,
-                     peakCoefficients);
-  updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients,
-                     peakCoefficients);
+juce::NormalisableRange<float>
+getQualityRange()
+{
+  return { 0.1f, 10.f, 0.05f, 1.f };
 }
 
 void
-updateCoefficients(Coefficients& old, const Coefficients& replacements)
+designPeakFilter(Filter& filter,
+                 const ChainSettings& chainSettings,
+                 double sampleRate)
 {
-  *old = *replacements;
+  // the same RBJ peak juce's makePeakFilter designs, without allocating a new
+  // set of coefficients for it
+  BandSettings peak{ BandType_Peak,
+                     chainSettings.peakFreq,
+                     chainSettings.peakGainInDecibles,
+                     chainSettings.peakQuality,
+                     false };
+
+  BiquadCoefficients coefficients;
+  designBand(peak, sampleRate, coefficients);
+
+  std::copy(coefficients.begin(),
+            coefficients.end(),
+            getBiquadCoefficients(filter));
 }
 
 void
-SimpleEqAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings)
+SimpleEqAudioProcessor::updatePeakFilter(
+  const StereoChainSettings& chainSettings)
 {
-  auto cutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
+  const auto& left = chainSettings[0];
+  const auto& right = chainSettings[1];
+
+  leftChain.setBypassed<ChainPositions::Peak>(left.peakBypassed);
+  rightChain.setBypassed<ChainPositions::Peak>(right.peakBypassed);
+
+  auto& leftPeak = leftChain.get<ChainPositions::Peak>();
+  auto& rightPeak = rightChain.get<ChainPositions::Peak>();
+  designPeakFilter(leftPeak, left, getSampleRate());
+
+  // linked channels share one design
+  if (peakSettingsMatch(left, right)) {
+    std::copy_n(
+      getBiquadCoefficients(leftPeak), 5, getBiquadCoefficients(rightPeak));
+  } else {
+    designPeakFilter(rightPeak, right, getSampleRate());
+  }
+}
 
-  auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-  auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
+float*
+getBiquadCoefficients(Filter& filter)
+{
+  // coefficients copied in from elsewhere may not be a biquad's, this only
+  // allocates if they aren't
+  if (filter.coefficients->coefficients.size() != 5) {
+    *filter.coefficients = juce::dsp::IIR::Coefficients<float>(1, 0, 0, 1, 0, 0);
+  }
 
-  leftChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
-  rightChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
+  return filter.coefficients->getRawCoefficients();
+}
 
-  updateCutFilter(leftLowCut, cutCoefficients, chainSettings.lowCutSlope);
-  updateCutFilter(rightLowCut, cutCoefficients, chainSettings.lowCutSlope);
+void
+SimpleEqAudioProcessor::updateLowCutFilters(
+  const StereoChainSettings& chainSettings)
+{
+  const auto& left = chainSettings[0];
+  const auto& right = chainSettings[1];
+
+  leftChain.setBypassed<ChainPositions::LowCut>(left.lowCutBypassed);
+  rightChain.setBypassed<ChainPositions::LowCut>(right.lowCutBypassed);
+
+  updateCutFilter(leftChain.get<ChainPositions::LowCut>(),
+                  false,
+                  left.lowCutFreq,
+                  getSampleRate(),
+                  left.lowCutSlope);
+
+  if (lowCutSettingsMatch(left, right)) {
+    copyCutFilter(leftChain.get<ChainPositions::LowCut>(),
+                  rightChain.get<ChainPositions::LowCut>(),
+                  right.lowCutSlope);
+  } else {
+    updateCutFilter(rightChain.get<ChainPositions::LowCut>(),
+                    false,
+                    right.lowCutFreq,
+                    getSampleRate(),
+                    right.lowCutSlope);
+  }
+}
+
+void
+SimpleEqAudioProcessor::updateHighCutFilters(
+  const StereoChainSettings& chainSettings)
+{
+  const auto& left = chainSettings[0];
+  const auto& right = chainSettings[1];
+
+  leftChain.setBypassed<ChainPositions::HighCut>(left.highCutBypassed);
+  rightChain.setBypassed<ChainPositions::HighCut>(right.highCutBypassed);
+
+  updateCutFilter(leftChain.get<ChainPositions::HighCut>(),
+                  true,
+                  left.highCutFreq,
+                  getSampleRate(),
+                  left.highCutSlope);
+
+  if (highCutSettingsMatch(left, right)) {
+    copyCutFilter(leftChain.get<ChainPositions::HighCut>(),
+                  rightChain.get<ChainPositions::HighCut>(),
+                  right.highCutSlope);
+  } else {
+    updateCutFilter(rightChain.get<ChainPositions::HighCut>(),
+                    true,
+                    right.highCutFreq,
+                    getSampleRate(),
+                    right.highCutSlope);
+  }
 }
 
 void
-SimpleEqAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings)
+SimpleEqAudioProcessor::updateTailLength(
+  const StereoChainSettings& chainSettings)
 {
-  auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
+  tailLengthSeconds.store(
+    juce::jmax(getTailLengthSeconds(chainSettings[0], silenceThreshold),
+               getTailLengthSeconds(chainSettings[1], silenceThreshold)));
+}
+
+int
+SimpleEqAudioProcessor::updateFilters(const StereoChainSettings& chainSettings,
+                                      int redesignBudget)
+{
+  // after prepareToPlay every band needs designing for the new sample rate,
+  // whatever the budget
+  const auto redesignAll = !appliedSettingsValid;
+
+  // round robin, so a tight budget still gets around to every band
+  constexpr int numBands = NumFixedBands + MultiBandFilter::MaxBands;
+  const auto firstBand = nextBandToRedesign;
+  int numRedesigned = 0;
+
+  for (int n = 0; n < numBands; ++n) {
+    if (!redesignAll && numRedesigned >= redesignBudget)
+      break;
+
+    auto band = (firstBand + n) % numBands;
+    if (!redesignAll && !bandChanged(band, chainSettings))
+      continue;
 
-  auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-  auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
+    // switching a band off designs nothing, so it's free
+    if (redesignBand(band, chainSettings))
+      ++numRedesigned;
 
-  leftChain.setBypassed<ChainPositions::HighCut>(chainSettings.highCutBypassed);
-  rightChain.setBypassed<ChainPositions::HighCut>(
-    chainSettings.highCutBypassed);
+    nextBandToRedesign = (band + 1) % numBands;
+  }
 
-  updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-  updateCutFilter(
-    rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+  appliedSettingsValid = true;
+  return numRedesigned;
 }
 
-void
-SimpleEqAudioProcessor::updateFilters()
+bool
+SimpleEqAudioProcessor::bandChanged(
+  int band,
+  const StereoChainSettings& chainSettings) const
 {
-  auto chainSettings = getChainSettings(apvts);
+  for (int ch = 0; ch < 2; ++ch) {
+    const auto& settings = chainSettings[ch];
+    const auto& applied = appliedSettings[ch];
+
+    switch (band) {
+      case ChainPositions::LowCut:
+        // while a band stays bypassed its other settings don't matter, they
+        // are designed when it is switched back on
+        if (settings.lowCutBypassed && applied.lowCutBypassed)
+          break;
+        if (!lowCutSettingsMatch(settings, applied))
+          return true;
+        break;
+      case ChainPositions::Peak:
+        if (settings.peakBypassed && applied.peakBypassed)
+          break;
+        if (!peakSettingsMatch(settings, applied))
+          return true;
+        break;
+      case ChainPositions::HighCut:
+        if (settings.highCutBypassed && applied.highCutBypassed)
+          break;
+        if (!highCutSettingsMatch(settings, applied))
+          return true;
+        break;
+      default: {
+        // the extra bands are shared, channel 0 has the settings
+        const auto& current = settings.bands[band - NumFixedBands];
+        const auto& previous = applied.bands[band - NumFixedBands];
+        return !(current.bypassed && previous.bypassed) && current != previous;
+      }
+    }
+  }
 
-  updateLowCutFilters(chainSettings);
-  updatePeakFilter(chainSettings);
-  updateHighCutFilters(chainSettings);
+  return false;
 }
 
-juce::AudioProcessorValueTreeState::ParameterLayout
-SimpleEqAudioProcessor::createParameterLayout()
+int
+SimpleEqAudioProcessor::getNumChangedBands(
+  const StereoChainSettings& chainSettings) const
 {
-  juce::AudioProcessorValueTreeState::ParameterLayout layout;
+  int numChanged = 0;
+  for (int band = 0; band < NumFixedBands + MultiBandFilter::MaxBands; ++band)
+    numChanged += bandChanged(band, chainSettings) ? 1 : 0;
+
+  return numChanged;
+}
+
+bool
+SimpleEqAudioProcessor::redesignBand(int band,
+                                     const StereoChainSettings& chainSettings)
+{
+  auto designed = true;
+
+  switch (band) {
+    case ChainPositions::LowCut: {
+      updateLowCutFilters(chainSettings);
+      break;
+    }
+    case ChainPositions::Peak: {
+      updatePeakFilter(chainSettings);
+      break;
+    }
+    case ChainPositions::HighCut: {
+      updateHighCutFilters(chainSettings);
+      break;
+    }
+    default: {
+      auto index = band - NumFixedBands;
+      const auto& settings = chainSettings[0].bands[index];
+      bandFilter.updateBand(index, settings);
+      designed = !settings.bypassed;
+      break;
+    }
+  }
+
+  for (int ch = 0; ch < 2; ++ch) {
+    const auto& settings = chainSettings[ch];
+    auto& applied = appliedSettings[ch];
+
+    switch (band) {
+      case ChainPositions::LowCut: {
+        applied.lowCutFreq = settings.lowCutFreq;
+        applied.lowCutSlope = settings.lowCutSlope;
+        applied.lowCutBypassed = settings.lowCutBypassed;
+        break;
+      }
+      case ChainPositions::Peak: {
+        applied.peakFreq = settings.peakFreq;
+        applied.peakGainInDecibles = settings.peakGainInDecibles;
+        applied.peakQuality = settings.peakQuality;
+        applied.peakBypassed = settings.peakBypassed;
+        break;
+      }
+      case ChainPositions::HighCut: {
+        applied.highCutFreq = settings.highCutFreq;
+        applied.highCutSlope = settings.highCutSlope;
+        applied.highCutBypassed = settings.highCutBypassed;
+        break;
+      }
+      default: {
+        auto index = band - NumFixedBands;
+        applied.bands[index] = settings.bands[index];
+        break;
+      }
+    }
+  }
+
+  return designed;
+}
+
+void
+addChainParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
+                   ChainParameterSet set,
+                   int versionHint)
+{
+  const auto& ids = getChainParameterIDs(set);
+
   layout.add(std::make_unique<juce::AudioParameterFloat>(
-    juce::ParameterID("LowCut Freq", 1),
-    "LowCut Freq",
-    juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
+    juce::ParameterID(ids.lowCutFreq, versionHint),
+    ids.lowCutFreq,
+    getFrequencyRange(),
     20.f));
   layout.add(std::make_unique<juce::AudioParameterFloat>(
-    juce::ParameterID("HighCut Freq", 1),
-    "HighCut Freq",
-    juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
+    juce::ParameterID(ids.highCutFreq, versionHint),
+    ids.highCutFreq,
+    getFrequencyRange(),
     20000.f));
   layout.add(std::make_unique<juce::AudioParameterFloat>(
-    juce::ParameterID("Peak Freq", 1),
-    "Peak Freq",
-    juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
+    juce::ParameterID(ids.peakFreq, versionHint),
+    ids.peakFreq,
+    getFrequencyRange(),
     750.f));
 
   layout.add(std::make_unique<juce::AudioParameterFloat>(
-    juce::ParameterID("Peak Gain", 1),
-    "Peak Gain",
-    juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f),
+    juce::ParameterID(ids.peakGain, versionHint),
+    ids.peakGain,
+    getGainRange(),
     0.f));
 
   layout.add(std::make_unique<juce::AudioParameterFloat>(
-    juce::ParameterID("Peak Quality", 1),
-    "Peak Quality",
-    juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
+    juce::ParameterID(ids.peakQuality, versionHint),
+    ids.peakQuality,
+    getQualityRange(),
     1.f));
 
   juce::StringArray stringArray;
@@ -383,18 +1893,93 @@ SimpleEqAudioProcessor::createParameterLayout()
   }
 
   layout.add(std::make_unique<juce::AudioParameterChoice>(
-    juce::ParameterID("LowCut Slope", 1), "LowCut Slope", stringArray, 0));
+    juce::ParameterID(ids.lowCutSlope, versionHint),
+    ids.lowCutSlope,
+    stringArray,
+    0));
   layout.add(std::make_unique<juce::AudioParameterChoice>(
-    juce::ParameterID("HighCut Slope", 1), "HighCut Slope", stringArray, 0));
+    juce::ParameterID(ids.highCutSlope, versionHint),
+    ids.highCutSlope,
+    stringArray,
+    0));
   layout.add(std::make_unique<juce::AudioParameterBool>(
-    juce::ParameterID("LowCut Bypassed", 1), "LowCut Bypassed", false));
+    juce::ParameterID(ids.lowCutBypassed, versionHint),
+    ids.lowCutBypassed,
+    false));
   layout.add(std::make_unique<juce::AudioParameterBool>(
-    juce::ParameterID("Peak Bypassed", 1), "Peak Bypassed", false));
+    juce::ParameterID(ids.peakBypassed, versionHint),
+    ids.peakBypassed,
+    false));
   layout.add(std::make_unique<juce::AudioParameterBool>(
-    juce::ParameterID("HighCut Bypassed", 1), "HighCut Bypassed", false));
+    juce::ParameterID(ids.highCutBypassed, versionHint),
+    ids.highCutBypassed,
+    false));
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout
+SimpleEqAudioProcessor::createParameterLayout()
+{
+  // the binary state relies on the parameter order, so new parameters must be
+  // added at the end
+  juce::AudioProcessorValueTreeState::ParameterLayout layout;
+  addChainParameters(layout, MainParameters, 1);
   layout.add(std::make_unique<juce::AudioParameterBool>(
     juce::ParameterID("Analyzer Enabled", 1), "Analyzer Enabled", true));
 
+  juce::StringArray bandTypes{ "Peak",  "Low Shelf", "High Shelf",
+                               "Notch", "Low Cut",   "High Cut" };
+
+  const auto& bandIDs = getBandParameterIDs();
+  for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+    // spread the default frequencies evenly over the log frequency range
+    auto defaultFreq = juce::mapToLog10(
+      (i + 0.5f) / float(MultiBandFilter::MaxBands), 20.f, 20000.f);
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+      juce::ParameterID(bandIDs[i].type, 2), bandIDs[i].type, bandTypes, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+      juce::ParameterID(bandIDs[i].freq, 2),
+      bandIDs[i].freq,
+      getFrequencyRange(),
+      std::round(defaultFreq)));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+      juce::ParameterID(bandIDs[i].gain, 2),
+      bandIDs[i].gain,
+      getGainRange(),
+      0.f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+      juce::ParameterID(bandIDs[i].quality, 2),
+      bandIDs[i].quality,
+      getQualityRange(),
+      1.f));
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+      juce::ParameterID(bandIDs[i].bypassed, 2), bandIDs[i].bypassed, true));
+  }
+
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+    juce::ParameterID("Bypass", 2), "Bypass", false));
+
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+    juce::ParameterID("Morph", 2),
+    "Morph",
+    juce::NormalisableRange<float>(0.f, 1.f, 0.001f, 1.f),
+    0.f));
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+    juce::ParameterID("Morph Enabled", 2), "Morph Enabled", false));
+
+  // the side chain's own fixed bands, used in Mid/Side mode
+  addChainParameters(layout, SideParameters, 2);
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+    juce::ParameterID("Stereo Mode", 2),
+    "Stereo Mode",
+    juce::StringArray{ "Stereo", "Mid/Side" },
+    0));
+
+  // when unlinked in Stereo mode, the right channel uses the "Right ..." set
+  addChainParameters(layout, RightParameters, 2);
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+    juce::ParameterID("Channel Link", 2), "Channel Link", true));
+
   return layout;
 }
 
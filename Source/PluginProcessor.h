@@ -11,25 +11,40 @@
 #include <JuceHeader.h>
 
 #include <array>
+
+#include "BackgroundCache.h"
+#include "Biquad.h"
+#include "CutFilterDesign.h"
+#include "MemoryFootprint.h"
+#include "MultiBandFilter.h"
+#include "PresetLibrary.h"
+#include "StereoMeter.h"
 template<typename T>
 struct Fifo
 {
-  void prepare(int numChannels, int numSamples)
+  static constexpr int DefaultCapacity = 30;
+
+  // the capacity is set when preparing, nothing may push or pull meanwhile
+  void prepare(int numChannels,
+               int numSamples,
+               int capacity = DefaultCapacity)
   {
     static_assert(std::is_same_v<T, juce::AudioBuffer<float>>,
                   "prepare(numChannles, numSamples) should only be used when "
                   "the Fifo is holding juce::AudioBuffer<float>");
+    setCapacity(capacity);
     for (auto& buffer : buffers) {
       buffer.setSize(numChannels, numSamples, false, true, true);
       buffer.clear();
     }
   }
 
-  void prepare(size_t numElements)
+  void prepare(size_t numElements, int capacity = DefaultCapacity)
   {
     static_assert(std::is_same_v<T, std::vector<float>>,
                   "prepare(numElements) should only be used when the Fifo is "
                   "holding std::vector<float>");
+    setCapacity(capacity);
     for (auto& buffer : buffers) {
       buffer.clear();
       buffer.resize(numElements, 0);
@@ -59,11 +74,28 @@ struct Fifo
   }
 
   int getNumAvailableForReading() const { return fifo.getNumReady(); }
+  int getCapacity() const { return (int)buffers.size(); }
+
+  size_t getMemoryBytes() const
+  {
+    size_t bytes = 0;
+    for (const auto& buffer : buffers)
+      bytes += ::getMemoryBytes(buffer);
+    return bytes;
+  }
 
 private:
-  static constexpr int Capacity = 30;
-  std::array<T, Capacity> buffers;
-  juce::AbstractFifo fifo{ Capacity };
+  // nothing is held until the fifo is first prepared
+  std::vector<T> buffers;
+  juce::AbstractFifo fifo{ DefaultCapacity };
+
+  void setCapacity(int capacity)
+  {
+    jassert(capacity > 1);
+    buffers.resize((size_t)capacity);
+    buffers.shrink_to_fit();
+    fifo.setTotalSize(capacity);
+  }
 };
 
 enum Channel
@@ -81,27 +113,51 @@ struct SingleChannelSampleFifo
     prepared.set(false);
   }
 
+  // the analysis hop, fixed so the analyzer's rate doesn't depend on the
+  // host's block size
+  static constexpr int DefaultHopSize = 512;
+
   void update(const BlockType& buffer)
   {
     jassert(prepared.get());
     jassert(buffer.getNumChannels() > channelToUse);
     auto* channelPtr = buffer.getReadPointer(channelToUse);
-
-    for (int i = 0; i < buffer.getNumSamples(); ++i) {
-      pushNextSampleIntoFifo(channelPtr[i]);
+    const auto numSamples = buffer.getNumSamples();
+    const auto hopSize = bufferToFill.getNumSamples();
+
+    // copied a hop at a time, so blocks of any size, even larger than the
+    // host promised, go through without reallocating
+    for (int i = 0; i < numSamples;) {
+      auto num = juce::jmin(hopSize - fifoIndex, numSamples - i);
+      juce::FloatVectorOperations::copy(
+        bufferToFill.getWritePointer(0, fifoIndex), channelPtr + i, num);
+
+      fifoIndex += num;
+      i += num;
+
+      if (fifoIndex == hopSize) {
+        // the analyzer fell behind, the hop is lost
+        if (!audioBufferFifo.push(bufferToFill))
+          ++numDroppedHops;
+
+        fifoIndex = 0;
+      }
     }
   }
 
-  void prepare(int bufferSize)
+  // 'capacity' is how many hops can queue up before the analyzer pulls them
+  void prepare(int hopSize = DefaultHopSize,
+               int capacity = Fifo<BlockType>::DefaultCapacity)
   {
     prepared.set(false);
-    size.set(bufferSize);
+    size.set(hopSize);
 
-    bufferToFill.setSize(1, bufferSize, false, true, true);
+    bufferToFill.setSize(1, hopSize, false, true, true);
 
     // avoid reallocating
-    audioBufferFifo.prepare(1, bufferSize);
+    audioBufferFifo.prepare(1, hopSize, capacity);
     fifoIndex = 0;
+    numDroppedHops.set(0);
     prepared.set(true);
   }
 
@@ -114,6 +170,14 @@ struct SingleChannelSampleFifo
   bool isPrepared() const { return prepared.get(); }
 
   int getSize() const { return size.get(); }
+
+  // hops that found the fifo full since it was prepared
+  int getNumDroppedHops() const { return numDroppedHops.get(); }
+
+  size_t getMemoryBytes() const
+  {
+    return ::getMemoryBytes(bufferToFill) + audioBufferFifo.getMemoryBytes();
+  }
   //============================================================================
   bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
 
@@ -124,40 +188,75 @@ private:
   BlockType bufferToFill;
   juce::Atomic<bool> prepared = false;
   juce::Atomic<int> size = 0;
+  juce::Atomic<int> numDroppedHops = 0;
+};
 
-  void pushNextSampleIntoFifo(float sample)
-  {
-    if (fifoIndex == bufferToFill.getNumSamples()) {
-      auto ok = audioBufferFifo.push(bufferToFill);
-
-      juce::ignoreUnused(ok);
+struct ChainSettings
+{
+  float peakFreq{ 0 }, peakGainInDecibles{ 0 }, peakQuality{ 1.f };
+  float lowCutFreq{ 0 }, highCutFreq{ 0 };
+  Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
 
-      fifoIndex = 0;
-    }
+  bool lowCutBypassed{ false }, peakBypassed{ false }, highCutBypassed{ false };
 
-    bufferToFill.setSample(0, fifoIndex, sample);
-    ++fifoIndex;
-  }
+  MultiBandFilter::Settings bands;
 };
 
-enum Slope
+bool
+operator==(const ChainSettings& lhs, const ChainSettings& rhs);
+bool
+operator!=(const ChainSettings& lhs, const ChainSettings& rhs);
+
+bool
+lowCutSettingsMatch(const ChainSettings& lhs, const ChainSettings& rhs);
+bool
+peakSettingsMatch(const ChainSettings& lhs, const ChainSettings& rhs);
+bool
+highCutSettingsMatch(const ChainSettings& lhs, const ChainSettings& rhs);
+
+// the settings for the left and right chains, or the mid and side chains in
+// Mid/Side mode
+using StereoChainSettings = std::array<ChainSettings, 2>;
+
+// the fixed bands have extra sets of parameters for the side signal, and for
+// the right channel when the channels aren't linked
+enum ChainParameterSet
 {
-  Slope_12,
-  Slope_24,
-  Slope_36,
-  Slope_48,
+  MainParameters,
+  SideParameters,
+  RightParameters,
+  NumChainParameterSets
 };
 
-struct ChainSettings
+struct ChainParameterIDs
 {
-  float peakFreq{ 0 }, peakGainInDecibles{ 0 }, peakQuality{ 1.f };
-  float lowCutFreq{ 0 }, highCutFreq{ 0 };
-  Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
+  juce::String lowCutFreq, highCutFreq, peakFreq, peakGain, peakQuality;
+  juce::String lowCutSlope, highCutSlope;
+  juce::String lowCutBypassed, peakBypassed, highCutBypassed;
+};
 
-  bool lowCutBypassed{ false }, peakBypassed{ false }, highCutBypassed{ false };
+const ChainParameterIDs&
+getChainParameterIDs(ChainParameterSet set);
+
+struct BandParameterIDs
+{
+  juce::String type, freq, gain, quality, bypassed;
 };
 
-using Filter = juce::dsp::IIR::Filter<float>;
+// built once, so looking the band parameters up doesn't allocate
+const std::array<BandParameterIDs, MultiBandFilter::MaxBands>&
+getBandParameterIDs();
+
+// the ranges of the frequency, gain and quality parameters, the same for every
+// set and band
+juce::NormalisableRange<float>
+getFrequencyRange();
+juce::NormalisableRange<float>
+getGainRange();
+juce::NormalisableRange<float>
+getQualityRange();
+
+using Filter = Biquad;
 
 using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
 
@@ -171,26 +270,22 @@ enum ChainPositions
 };
 
 using Coefficients = Filter::CoefficientsPtr;
-void
-updateCoefficients(Coefficients& old, const Coefficients& replacments);
 
-Coefficients
-makePeakFilter(const ChainSettings& chainSettings, double sampleRate);
+// makes sure the filter holds a biquad's worth of coefficients, so designs can
+// be written straight into it
+float*
+getBiquadCoefficients(Filter& filter);
 
-template<int Index, typename ChainType, typename CoefficientType>
+// designs the peak band straight into the filter's coefficients, so it
+// doesn't allocate and is safe to call from the audio thread
 void
-update(ChainType& chain, const CoefficientType& coefficients)
-{
-  updateCoefficients(chain.template get<Index>().coefficients,
-                     coefficients[Index]);
-  chain.template setBypassed<Index>(false);
-}
+designPeakFilter(Filter& filter,
+                 const ChainSettings& chainSettings,
+                 double sampleRate);
 
-template<typename ChainType, typename CoefficientType>
+template<typename ChainType>
 void
-updateCutFilter(ChainType& chain,
-                const CoefficientType& coefficients,
-                const Slope& slope)
+setCutFilterSlope(ChainType& chain, const Slope& slope)
 {
   chain.template setBypassed<0>(true);
   chain.template setBypassed<1>(true);
@@ -199,42 +294,161 @@ updateCutFilter(ChainType& chain,
 
   switch (slope) {
     case Slope_48: {
-      update<3>(chain, coefficients);
+      chain.template setBypassed<3>(false);
     }
     case Slope_36: {
-      update<2>(chain, coefficients);
+      chain.template setBypassed<2>(false);
     }
     case Slope_24: {
-      update<1>(chain, coefficients);
+      chain.template setBypassed<1>(false);
     }
     case Slope_12: {
-      update<0>(chain, coefficients);
+      chain.template setBypassed<0>(false);
     }
   }
 }
 
-ChainSettings
-getChainSettings(juce::AudioProcessorValueTreeState& apvts);
-
-inline auto
-makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate)
+template<typename ChainType>
+void
+updateCutFilter(ChainType& chain,
+                bool isHighCut,
+                float freq,
+                double sampleRate,
+                const Slope& slope)
 {
-  return juce::dsp::FilterDesign<float>::
-    designIIRHighpassHighOrderButterworthMethod(
-      chainSettings.lowCutFreq,
-      sampleRate,
-      2 * (chainSettings.lowCutSlope + 1));
+  std::array<float*, MaxCutFilterSections> sections{
+    getBiquadCoefficients(chain.template get<0>()),
+    getBiquadCoefficients(chain.template get<1>()),
+    getBiquadCoefficients(chain.template get<2>()),
+    getBiquadCoefficients(chain.template get<3>())
+  };
+
+  designCutFilter(isHighCut, freq, sampleRate, slope, sections.data());
+
+  setCutFilterSlope(chain, slope);
 }
 
-inline auto
-makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate)
+// copies an already designed cut filter, cheaper than designing it again
+template<typename ChainType>
+void
+copyCutFilter(ChainType& source, ChainType& dest, const Slope& slope)
 {
-  return juce::dsp::FilterDesign<float>::
-    designIIRLowpassHighOrderButterworthMethod(
-      chainSettings.highCutFreq,
-      sampleRate,
-      2 * (chainSettings.highCutSlope + 1));
+  std::array<float*, MaxCutFilterSections> from{
+    getBiquadCoefficients(source.template get<0>()),
+    getBiquadCoefficients(source.template get<1>()),
+    getBiquadCoefficients(source.template get<2>()),
+    getBiquadCoefficients(source.template get<3>())
+  };
+  std::array<float*, MaxCutFilterSections> to{
+    getBiquadCoefficients(dest.template get<0>()),
+    getBiquadCoefficients(dest.template get<1>()),
+    getBiquadCoefficients(dest.template get<2>()),
+    getBiquadCoefficients(dest.template get<3>())
+  };
+
+  for (int i = 0; i < getNumCutFilterSections(slope); ++i) {
+    std::copy(from[i], from[i] + 5, to[i]);
+  }
+
+  setCutFilterSlope(dest, slope);
 }
+
+ChainSettings
+getChainSettings(juce::AudioProcessorValueTreeState& apvts,
+                 ChainParameterSet set = MainParameters);
+
+// sets the parameters of 'set' to match 'chainSettings', notifying the host.
+// the extra bands are only set for the main set, the others don't have any
+void
+setChainSettings(juce::AudioProcessorValueTreeState& apvts,
+                 const ChainSettings& chainSettings,
+                 ChainParameterSet set = MainParameters);
+
+// blends 'a' into 'b' as 'amount' goes from 0 to 1. frequencies and Qs move
+// in the log domain, and choices switch over half way
+ChainSettings
+morphChainSettings(const ChainSettings& a, const ChainSettings& b, float amount);
+
+// true when the settings leave the signal untouched, e.g. every band is
+// bypassed or the peak has no gain
+bool
+isIdentity(const ChainSettings& chainSettings);
+
+// how long the filters keep ringing after the input stops, until they are
+// 'decayGain' below the level they were driven at
+double
+getTailLengthSeconds(const ChainSettings& chainSettings, double decayGain);
+
+// runs the left and right chains, then the extra bands, over a stereo block.
+// in Mid/Side mode the left chain filters the mid signal and the right chain
+// the side signal. shared by the processor and the offline renderer, so the
+// two always process the same way
+void
+processStereoChains(MonoChain& leftChain,
+                    MonoChain& rightChain,
+                    MultiBandFilter& bandFilter,
+                    juce::dsp::AudioBlock<float>& block,
+                    bool midSide);
+
+/* The complete DSP state of a processor: the coefficients and state of every
+   section, the settings they were designed from, and where any parameter
+   ramp, fade or sleep had got to. Fixed size and trivially copyable, so it
+   can be kept, copied and restored without allocating.
+   The input recorded to prime the filters isn't included, it depends on the
+   sample rate. A restored processor that is transparent primes its filters
+   from the input that arrives after the restore.
+*/
+struct DSPStateSnapshot
+{
+  struct Section
+  {
+    BiquadCoefficients coefficients;
+    Biquad::State state;
+    bool bypassed;
+  };
+
+  struct Chain
+  {
+    std::array<Section, MaxCutFilterSections> lowCut, highCut;
+    Section peak;
+    bool lowCutBypassed, highCutBypassed;
+  };
+
+  double sampleRate;
+  std::array<Chain, 2> chains;
+  MultiBandFilter::State bandFilter;
+
+  StereoChainSettings appliedSettings, currentSettings;
+  StereoChainSettings rampStart, rampTarget;
+  int rampPosition, rampLength, nextBandToRedesign;
+
+  // a fade in progress restarts from its current gain, over the full fade
+  float wetGain, wetGainTarget;
+
+  juce::int64 numSilentSamples;
+  bool isSleeping;
+
+  // the mode the filters run in, and the Stereo Mode parameter, which differ
+  // while the mode is being switched
+  bool processMidSide, stereoModeMidSide;
+};
+
+static_assert(std::is_trivially_copyable_v<DSPStateSnapshot>,
+              "DSPStateSnapshots must copy without allocating");
+
+// how much an instance sets aside for the editor's analyzer. with hundreds of
+// instances in a session most never have their editor opened
+enum MemoryBudget
+{
+  // the analyzer taps are allocated when the processor is prepared, with room
+  // for Fifo::DefaultCapacity hops each
+  MemoryBudget_Full,
+  // the taps hold fewer hops, and aren't allocated until an editor first opens
+  MemoryBudget_Compact,
+};
+
+struct ParameterSnapshot;
+
 //==============================================================================
 /**
  */
@@ -254,6 +468,10 @@ public:
 #endif
 
   void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+  void processBlockBypassed(juce::AudioBuffer<float>&,
+                            juce::MidiBuffer&) override;
+
+  juce::AudioProcessorParameter* getBypassParameter() const override;
 
   //==============================================================================
   juce::AudioProcessorEditor* createEditor() override;
@@ -278,6 +496,14 @@ public:
   void getStateInformation(juce::MemoryBlock& destData) override;
   void setStateInformation(const void* data, int sizeInBytes) override;
 
+  // restores a state written by getStateInformation, returns false if the data
+  // isn't in the binary format. a state from a newer version is accepted and
+  // ignored
+  bool setBinaryState(const void* data, int sizeInBytes);
+
+  // identifies the IDs of the first 'numParameters' parameters, in order
+  juce::uint32 getParameterLayoutHash(int numParameters) const;
+
   static juce::AudioProcessorValueTreeState::ParameterLayout
   createParameterLayout();
   juce::AudioProcessorValueTreeState apvts{ *this,
@@ -285,19 +511,225 @@ public:
                                             "Parameters",
                                             createParameterLayout() };
 
+  // the newest settings of each parameter set, versioned. cheaper than
+  // getChainSettings and safe to read from any thread
+  ParameterSnapshot& getParameterSnapshot(ChainParameterSet set)
+  {
+    return *parameterSnapshots[set];
+  }
+
+  //==============================================================================
+  bool loadPresetLibrary(const juce::File& file);
+  const PresetLibrary& getPresetLibrary() const { return presetLibrary; }
+  void recallPreset(int index);
+
+  // for the Link button, on the message thread. unlinking copies the main
+  // settings into the "Right ..." set first, so the right channel carries on
+  // from where it was rather than from whatever the Right set last held.
+  // automation and restored states change the link without copying anything
+  void setChannelsLinked(bool shouldBeLinked);
+
+  // the two settings the 'Morph' parameter blends between, slot 0 or 1
+  void setMorphSnapshot(int slot, const ChainSettings& chainSettings);
+  ChainSettings getMorphSnapshot(int slot) const;
+
+  // capture and restore the filters mid-stream. call them from the audio
+  // thread, or while it isn't processing. a snapshot only restores at the
+  // sample rate and Stereo Mode it was taken at, anything else would fade the
+  // restored filters straight out again
+  void getDSPState(DSPStateSnapshot& snapshot) const;
+  bool setDSPState(const DSPStateSnapshot& snapshot);
+
+  // renders a whole stereo file with the current settings, split into chunks
+  // across the pool's threads. see OfflineRenderer
+  void renderOffline(const juce::AudioBuffer<float>& input,
+                     juce::AudioBuffer<float>& output,
+                     juce::ThreadPool& pool);
+
   using BlockType = juce::AudioBuffer<float>;
   SingleChannelSampleFifo<BlockType> leftChannelFifo{ Channel::Left };
   SingleChannelSampleFifo<BlockType> rightChannelFifo{ Channel::Right };
 
+  // the input, before the EQ. only fed while an editor shows it
+  SingleChannelSampleFifo<BlockType> preLeftChannelFifo{ Channel::Left };
+  SingleChannelSampleFifo<BlockType> preRightChannelFifo{ Channel::Right };
+  std::atomic<bool> preAnalysisEnabled{ false };
+
+  // measures the output, the editor reads it at frame rate
+  StereoMeter outputMeter;
+
+  // call from the message thread. takes effect the next time the processor is
+  // prepared, or when an editor first opens if the taps haven't been
+  // allocated yet. saved with the state, it isn't a parameter
+  void setMemoryBudget(MemoryBudget newBudget) { memoryBudget = newBudget; }
+  MemoryBudget getMemoryBudget() const { return memoryBudget; }
+
+  // called by the editor when it opens, allocates the analyzer taps if the
+  // budget deferred them
+  void attachAnalyzer();
+
+  // what this instance holds, including its editor if one is open, and what
+  // it shares with the other instances. call from the message thread
+  MemoryFootprint getMemoryFootprint() const;
+
 private:
+  std::array<std::unique_ptr<ParameterSnapshot>, NumChainParameterSets>
+    parameterSnapshots;
+
+  // the audio thread's copy of each parameter set, and its version
+  using ParameterSetSettings = std::array<ChainSettings, NumChainParameterSets>;
+  ParameterSetSettings audioParameters;
+  std::array<juce::uint32, NumChainParameterSets> audioParameterVersions{};
+
+  void updateAudioParameters();
+
+  std::vector<juce::uint32> parameterLayoutHashes;
+  void updateParameterLayoutHashes();
+
   MonoChain leftChain, rightChain;
+  MultiBandFilter bandFilter;
+
+  void updatePeakFilter(const StereoChainSettings& chainSettings);
+
+  void updateLowCutFilters(const StereoChainSettings& chainSettings);
+  void updateHighCutFilters(const StereoChainSettings& chainSettings);
+
+  // redesigns at most 'redesignBudget' of the bands that changed since the
+  // last update, the rest catch up on later calls. the extra bands are shared
+  // by both chains and come from chainSettings[0]. returns how many were
+  // redesigned
+  int updateFilters(const StereoChainSettings& chainSettings,
+                    int redesignBudget = std::numeric_limits<int>::max());
+
+  // once per block, from the settings the filters are heading for
+  void updateTailLength(const StereoChainSettings& chainSettings);
 
-  void updatePeakFilter(const ChainSettings& chainSettings);
+  static constexpr int NumFixedBands = 3;
+  bool bandChanged(int band, const StereoChainSettings& chainSettings) const;
+  int getNumChangedBands(const StereoChainSettings& chainSettings) const;
+  // returns false if the band only needed switching off
+  bool redesignBand(int band, const StereoChainSettings& chainSettings);
 
-  void updateLowCutFilters(const ChainSettings& chainSettings);
-  void updateHighCutFilters(const ChainSettings& chainSettings);
+  StereoChainSettings appliedSettings;
+  bool appliedSettingsValid = false;
+  int nextBandToRedesign = 0;
 
-  void updateFilters();
+  PresetLibrary presetLibrary;
+
+  // a morph sweep would redesign every band on every sub-block. while it
+  // runs each band that moves is redesigned at most once per block instead,
+  // and never fewer than this many bands per block
+  static constexpr int morphRedesignBudget = 4;
+
+  std::atomic<float>* morphAmount = nullptr;
+  std::atomic<float>* morphEnabled = nullptr;
+
+  mutable juce::SpinLock morphLock;
+  std::array<ChainSettings, 2> morphSnapshots;
+  std::atomic<int> morphSnapshotsVersion{ 0 };
+
+  // the audio thread's copy of morphSnapshots
+  std::array<ChainSettings, 2> audioMorphSnapshots;
+  int audioMorphSnapshotsVersion = -1;
+
+  void updateAudioMorphSnapshots();
+
+  // keeps the editor's prerendered backgrounds alive between editor opens
+  juce::SharedResourcePointer<BackgroundCache> editorBackgrounds;
+
+  MemoryBudget memoryBudget = MemoryBudget_Full;
+  static constexpr int compactFifoCapacity = 8;
+
+  // the audio thread only feeds the analyzer taps once they are allocated.
+  // the lock keeps prepareToPlay and attachAnalyzer from allocating them at
+  // the same time, the audio thread never takes it
+  juce::CriticalSection analyzerFifoLock;
+  bool analyzerAttached = false;
+  std::atomic<bool> analyzerFifosReady{ false };
+
+  void prepareAnalyzerFifos();
+
+  void process(juce::AudioBuffer<float>& buffer, bool bypassed);
+  // spends from 'redesignBudget', which is shared by every call in a block
+  void processFiltered(juce::dsp::AudioBlock<float>& block,
+                       int& redesignBudget);
+  void processChains(juce::dsp::AudioBlock<float>& block);
+
+  // in Mid/Side mode the left chain filters the mid signal and the right chain
+  // the side signal
+  std::atomic<float>* stereoMode = nullptr;
+  std::atomic<float>* channelLink = nullptr;
+  bool processMidSide = false;
+
+  StereoChainSettings makeStereoChainSettings(
+    const ChainSettings& main,
+    const ParameterSetSettings& parameters,
+    bool midSide,
+    bool linked);
+
+  // the channels stay linked while setChannelsLinked copies the Right set
+  std::atomic<bool> rightSetPending{ false };
+
+  bool isLinked() const;
+
+  // parameter changes ramp over rampLengthSamples (20 ms), and the filters
+  // are redesigned every automationSubBlockSize samples while they do. a
+  // change during a ramp shortens the new ramp to what was left of the old
+  // one, see rampToSettings
+  static constexpr int automationSubBlockSize = 32;
+
+  StereoChainSettings currentSettings, rampStart, rampTarget;
+  int rampPosition = 0;
+  int rampLength = 0;
+  int rampLengthSamples = 0;
+
+  void jumpToSettings(const StereoChainSettings& chainSettings);
+  void rampToSettings(const StereoChainSettings& chainSettings);
+
+  void recordWarmUpHistory(const juce::AudioBuffer<float>& buffer);
+
+  // priming replays the history a bounded number of samples per block, so a
+  // long tail doesn't cost a whole spike in the block the filters come back.
+  // continueWarmUp returns true once the filters have caught up with the input
+  void startWarmUp();
+  bool continueWarmUp(int maxSamples);
+
+  // fed to the output taps for blocks that return the input unchanged
+  void feedOutputTaps(const juce::AudioBuffer<float>& buffer,
+                      bool analyzerFifosReadyForBlock);
+
+  juce::AudioParameterBool* bypassParameter = nullptr;
+
+  // 1 when the filters are heard, 0 when the instance is transparent
+  juce::SmoothedValue<float> wetGain;
+  juce::AudioBuffer<float> dryBuffer;
+  std::vector<float> fadeGains;
+
+  // the most recent input while transparent, used to prime the filter states
+  // before they are heard again. the history is capped, a tail longer than
+  // this isn't fully primed and can still click when the filters come back
+  static constexpr double maxWarmUpSeconds = 0.5;
+  juce::AudioBuffer<float> warmUpBuffer;
+  int warmUpWriteIndex = 0;
+
+  // while warming up, the history from warmUpReadIndex on hasn't been
+  // replayed yet. at least this many samples are replayed per block, and
+  // twice the block size if that's more, so the backlog always shrinks
+  static constexpr int warmUpSamplesPerBlock = 4096;
+  bool warmingUp = false;
+  int warmUpReadIndex = 0;
+  int numWarmUpSamplesPending = 0;
+
+  // -100 dBFS, anything below this is treated as silence
+  static constexpr float silenceThreshold = 1e-5f;
+
+  std::atomic<double> tailLengthSeconds{ 0.0 };
+  juce::int64 numSilentSamples = 0;
+  bool isSleeping = false;
+
+  // the largest z1 or z2 across every section, checked before sleeping
+  float getFilterStateMagnitude() const;
+  void sleep();
 
   juce::dsp::Oscillator<float> osc;
   //==============================================================================
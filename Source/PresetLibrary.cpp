@@ -0,0 +1,259 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "PresetLibrary.h"
+
+#include "PluginProcessor.h"
+
+PresetRecord
+makePresetRecord(const ChainSettings& chainSettings, const juce::String& name)
+{
+  PresetRecord record{};
+
+  name.copyToUTF8(record.name, PresetRecord::MaxNameLength);
+
+  record.peakFreq = chainSettings.peakFreq;
+  record.peakGainInDecibels = chainSettings.peakGainInDecibles;
+  record.peakQuality = chainSettings.peakQuality;
+  record.lowCutFreq = chainSettings.lowCutFreq;
+  record.highCutFreq = chainSettings.highCutFreq;
+  record.lowCutSlope = (juce::uint8)chainSettings.lowCutSlope;
+  record.highCutSlope = (juce::uint8)chainSettings.highCutSlope;
+  record.lowCutBypassed = chainSettings.lowCutBypassed;
+  record.peakBypassed = chainSettings.peakBypassed;
+  record.highCutBypassed = chainSettings.highCutBypassed;
+
+  for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+    const auto& band = chainSettings.bands[i];
+    record.bands[i].freq = band.freq;
+    record.bands[i].gainInDecibels = band.gainInDecibels;
+    record.bands[i].quality = band.quality;
+    record.bands[i].type = (juce::uint8)band.type;
+    record.bands[i].bypassed = band.bypassed;
+  }
+
+  return record;
+}
+
+// a value read from a file, clamped to its parameter's range. one that isn't
+// a number at all is replaced by 'fallback'
+float
+sanitise(float value,
+         const juce::NormalisableRange<float>& range,
+         float fallback)
+{
+  if (!std::isfinite(value))
+    return fallback;
+
+  return juce::jlimit(range.start, range.end, value);
+}
+
+template<typename Enum>
+Enum
+sanitise(juce::uint8 value, Enum last, Enum fallback)
+{
+  return value <= (int)last ? static_cast<Enum>(value) : fallback;
+}
+
+ChainSettings
+getChainSettings(const PresetRecord& record)
+{
+  // the records may come from anywhere, so nothing reaches the filter design
+  // without being checked. rejected values fall back to the parameter defaults
+  const auto frequencyRange = getFrequencyRange();
+  const auto gainRange = getGainRange();
+  const auto qualityRange = getQualityRange();
+
+  ChainSettings settings;
+
+  settings.peakFreq = sanitise(record.peakFreq, frequencyRange, 750.f);
+  settings.peakGainInDecibles =
+    sanitise(record.peakGainInDecibels, gainRange, 0.f);
+  settings.peakQuality = sanitise(record.peakQuality, qualityRange, 1.f);
+  settings.lowCutFreq = sanitise(record.lowCutFreq, frequencyRange, 20.f);
+  settings.highCutFreq = sanitise(record.highCutFreq, frequencyRange, 20000.f);
+  settings.lowCutSlope = sanitise(record.lowCutSlope, Slope_48, Slope_12);
+  settings.highCutSlope = sanitise(record.highCutSlope, Slope_48, Slope_12);
+  settings.lowCutBypassed = record.lowCutBypassed != 0;
+  settings.peakBypassed = record.peakBypassed != 0;
+  settings.highCutBypassed = record.highCutBypassed != 0;
+
+  for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+    const auto& saved = record.bands[i];
+    auto& band = settings.bands[i];
+    const BandSettings defaults;
+
+    band.freq = sanitise(saved.freq, frequencyRange, defaults.freq);
+    band.gainInDecibels =
+      sanitise(saved.gainInDecibels, gainRange, defaults.gainInDecibels);
+    band.quality = sanitise(saved.quality, qualityRange, defaults.quality);
+    band.type = sanitise(saved.type, BandType_HighCut, defaults.type);
+    band.bypassed = saved.bypassed != 0;
+  }
+
+  return settings;
+}
+
+void
+writePresetRecord(juce::OutputStream& stream, const PresetRecord& record)
+{
+  stream.write(record.name, PresetRecord::MaxNameLength);
+
+  for (auto value : { record.peakFreq,
+                      record.peakGainInDecibels,
+                      record.peakQuality,
+                      record.lowCutFreq,
+                      record.highCutFreq })
+    stream.writeFloat(value);
+
+  for (auto value : { record.lowCutSlope,
+                      record.highCutSlope,
+                      record.lowCutBypassed,
+                      record.peakBypassed,
+                      record.highCutBypassed })
+    stream.writeByte((char)value);
+
+  stream.write(record.unused, sizeof(record.unused));
+
+  for (const auto& band : record.bands) {
+    stream.writeFloat(band.freq);
+    stream.writeFloat(band.gainInDecibels);
+    stream.writeFloat(band.quality);
+    stream.writeByte((char)band.type);
+    stream.writeByte((char)band.bypassed);
+    stream.write(band.unused, sizeof(band.unused));
+  }
+}
+
+bool
+readPresetRecord(juce::InputStream& stream, PresetRecord& record)
+{
+  if (stream.getNumBytesRemaining() < (juce::int64)sizeof(PresetRecord))
+    return false;
+
+  record = {};
+  stream.read(record.name, PresetRecord::MaxNameLength);
+
+  for (auto* value : { &record.peakFreq,
+                       &record.peakGainInDecibels,
+                       &record.peakQuality,
+                       &record.lowCutFreq,
+                       &record.highCutFreq })
+    *value = stream.readFloat();
+
+  for (auto* value : { &record.lowCutSlope,
+                       &record.highCutSlope,
+                       &record.lowCutBypassed,
+                       &record.peakBypassed,
+                       &record.highCutBypassed })
+    *value = (juce::uint8)stream.readByte();
+
+  stream.skipNextBytes(sizeof(record.unused));
+
+  for (auto& band : record.bands) {
+    band.freq = stream.readFloat();
+    band.gainInDecibels = stream.readFloat();
+    band.quality = stream.readFloat();
+    band.type = (juce::uint8)stream.readByte();
+    band.bypassed = (juce::uint8)stream.readByte();
+    stream.skipNextBytes(sizeof(band.unused));
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool
+PresetLibrary::open(const juce::File& file)
+{
+  close();
+
+  auto mapped = std::make_unique<juce::MemoryMappedFile>(
+    file, juce::MemoryMappedFile::readOnly);
+
+  if (mapped->getData() == nullptr || mapped->getSize() < sizeof(Header))
+    return false;
+
+  Header header;
+  std::memcpy(&header, mapped->getData(), sizeof(Header));
+
+  if (header.magic != Header::expectedMagic ||
+      header.version > Header::currentVersion ||
+      header.recordSize != sizeof(PresetRecord))
+    return false;
+
+  auto available = (mapped->getSize() - sizeof(Header)) / sizeof(PresetRecord);
+  if (header.numPresets > available)
+    return false;
+
+  mappedFile = std::move(mapped);
+  records = static_cast<const char*>(mappedFile->getData()) + sizeof(Header);
+  numPresets = (int)header.numPresets;
+  return true;
+}
+
+void
+PresetLibrary::close()
+{
+  records = nullptr;
+  numPresets = 0;
+  mappedFile.reset();
+}
+
+juce::String
+PresetLibrary::getName(int index) const
+{
+  auto record = getRecord(index);
+  auto length = 0;
+  while (length < PresetRecord::MaxNameLength && record.name[length] != 0)
+    ++length;
+
+  return juce::String::fromUTF8(record.name, length);
+}
+
+ChainSettings
+PresetLibrary::getSettings(int index) const
+{
+  return getChainSettings(getRecord(index));
+}
+
+PresetRecord
+PresetLibrary::getRecord(int index) const
+{
+  PresetRecord record{};
+
+  if (juce::isPositiveAndBelow(index, numPresets)) {
+    // copied rather than cast, the mapping has no alignment guarantees
+    std::memcpy(&record, records + sizeof(PresetRecord) * index, sizeof(record));
+  } else {
+    jassertfalse;
+  }
+
+  return record;
+}
+
+bool
+PresetLibrary::write(const juce::File& file,
+                     const std::vector<PresetRecord>& records)
+{
+  Header header{ Header::expectedMagic,
+                 Header::currentVersion,
+                 (juce::uint32)records.size(),
+                 (juce::uint32)sizeof(PresetRecord) };
+
+  juce::FileOutputStream stream(file);
+  if (!stream.openedOk())
+    return false;
+
+  stream.setPosition(0);
+  stream.truncate();
+
+  return stream.write(&header, sizeof(Header)) &&
+         stream.write(records.data(), sizeof(PresetRecord) * records.size());
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "MultiBandFilter.h"
+
+struct ChainSettings;
+
+/* The on-disk form of a ChainSettings, fixed size and layout so a library of
+   them can be indexed without parsing.
+*/
+struct PresetRecord
+{
+  static constexpr int MaxNameLength = 32;
+
+  struct Band
+  {
+    float freq, gainInDecibels, quality;
+    juce::uint8 type, bypassed, unused[2];
+  };
+
+  char name[MaxNameLength];
+
+  float peakFreq, peakGainInDecibels, peakQuality;
+  float lowCutFreq, highCutFreq;
+  juce::uint8 lowCutSlope, highCutSlope;
+  juce::uint8 lowCutBypassed, peakBypassed, highCutBypassed, unused[3];
+
+  Band bands[MultiBandFilter::MaxBands];
+};
+
+static_assert(std::is_trivially_copyable_v<PresetRecord>,
+              "PresetRecords are copied straight to and from disk");
+
+PresetRecord
+makePresetRecord(const ChainSettings& chainSettings, const juce::String& name);
+
+// clamped to the parameter ranges, anything that isn't a valid value or choice
+// falls back to the parameter's default
+ChainSettings
+getChainSettings(const PresetRecord& record);
+
+// field by field in little-endian order, the same bytes a PresetRecord has in
+// memory on the platforms we ship. reading returns false if the stream ran out
+void
+writePresetRecord(juce::OutputStream& stream, const PresetRecord& record);
+bool
+readPresetRecord(juce::InputStream& stream, PresetRecord& record);
+
+/* A read-only library of presets in a memory mapped file.
+   The file is a small header followed by an array of PresetRecords, so
+   looking a preset up is a bounds check and a copy.
+*/
+struct PresetLibrary
+{
+  bool open(const juce::File& file);
+  void close();
+
+  bool isOpen() const { return mappedFile != nullptr; }
+
+  int getNumPresets() const { return numPresets; }
+  juce::String getName(int index) const;
+  ChainSettings getSettings(int index) const;
+
+  static bool write(const juce::File& file,
+                    const std::vector<PresetRecord>& records);
+
+private:
+  struct Header
+  {
+    static constexpr juce::uint32 expectedMagic = 0x50514553; // "SEQP"
+    static constexpr juce::uint32 currentVersion = 1;
+
+    juce::uint32 magic, version, numPresets, recordSize;
+  };
+
+  std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+  const char* records = nullptr;
+  int numPresets = 0;
+
+  PresetRecord getRecord(int index) const;
+};
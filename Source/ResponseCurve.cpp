@@ -0,0 +1,370 @@
+/*
+  ==============================================================================
+
+    ResponseCurve.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "ResponseCurve.h"
+
+#include "PluginProcessor.h"
+
+#include <complex>
+
+void
+getBandSections(const ChainSettings& chainSettings,
+                int band,
+                double sampleRate,
+                std::vector<BiquadCoefficients>& sections)
+{
+  sections.clear();
+
+  auto addCutFilter = [&](bool isHighCut, float freq, Slope slope) {
+    std::array<BiquadCoefficients, MaxCutFilterSections> cut;
+    std::array<float*, MaxCutFilterSections> pointers{
+      cut[0].data(), cut[1].data(), cut[2].data(), cut[3].data()
+    };
+
+    designCutFilter(isHighCut, freq, sampleRate, slope, pointers.data());
+    sections.insert(
+      sections.end(), cut.begin(), cut.begin() + getNumCutFilterSections(slope));
+  };
+
+  switch (band) {
+    case ChainPositions::LowCut: {
+      if (!chainSettings.lowCutBypassed)
+        addCutFilter(
+          false, chainSettings.lowCutFreq, chainSettings.lowCutSlope);
+      break;
+    }
+    case ChainPositions::Peak: {
+      if (!chainSettings.peakBypassed) {
+        // the same RBJ peak juce's makePeakFilter designs
+        BandSettings peak{ BandType_Peak,
+                           chainSettings.peakFreq,
+                           chainSettings.peakGainInDecibles,
+                           chainSettings.peakQuality,
+                           false };
+        sections.emplace_back();
+        designBand(peak, sampleRate, sections.back());
+      }
+      break;
+    }
+    case ChainPositions::HighCut: {
+      if (!chainSettings.highCutBypassed)
+        addCutFilter(
+          true, chainSettings.highCutFreq, chainSettings.highCutSlope);
+      break;
+    }
+    default: {
+      const auto& extraBand = chainSettings.bands[band - 3];
+      if (!extraBand.bypassed) {
+        sections.emplace_back();
+        designBand(extraBand, sampleRate, sections.back());
+      }
+      break;
+    }
+  }
+}
+
+void
+getResponseSections(const ChainSettings& chainSettings,
+                    double sampleRate,
+                    std::vector<BiquadCoefficients>& sections)
+{
+  sections.clear();
+
+  std::vector<BiquadCoefficients> bandSections;
+  for (int band = 0; band < NumResponseBands; ++band) {
+    getBandSections(chainSettings, band, sampleRate, bandSections);
+    sections.insert(sections.end(), bandSections.begin(), bandSections.end());
+  }
+}
+
+void
+computeFrequencyResponse(const std::vector<BiquadCoefficients>& sections,
+                         double sampleRate,
+                         const std::vector<double>& freqs,
+                         FrequencyResponse& response)
+{
+  const auto numPoints = freqs.size();
+  response.magnitudeDecibels.resize(numPoints);
+  response.phaseRadians.resize(numPoints);
+  response.groupDelaySeconds.resize(numPoints);
+
+  for (size_t i = 0; i < numPoints; ++i) {
+    const auto w = juce::MathConstants<double>::twoPi * freqs[i] / sampleRate;
+    const auto z1 = std::polar(1.0, -w);
+    const auto z2 = z1 * z1;
+
+    std::complex<double> h(1.0);
+    double delaySamples = 0.0;
+
+    for (const auto& c : sections) {
+      auto b = double(c[0]) + double(c[1]) * z1 + double(c[2]) * z2;
+      auto a = 1.0 + double(c[3]) * z1 + double(c[4]) * z2;
+
+      // the group delay of a polynomial in z^-1 is Re(sum k c_k z^-k / sum
+      // c_k z^-k), and a section's is its numerator's minus its denominator's
+      auto bRamp = double(c[1]) * z1 + 2.0 * double(c[2]) * z2;
+      auto aRamp = double(c[3]) * z1 + 2.0 * double(c[4]) * z2;
+      delaySamples += (bRamp / b).real() - (aRamp / a).real();
+
+      h *= b / a;
+    }
+
+    response.magnitudeDecibels[i] =
+      float(juce::Decibels::gainToDecibels(std::abs(h), -200.0));
+    response.phaseRadians[i] = float(std::arg(h));
+    response.groupDelaySeconds[i] = float(delaySamples / sampleRate);
+  }
+}
+
+FrequencyResponse
+computeFrequencyResponse(const ChainSettings& chainSettings,
+                         double sampleRate,
+                         const std::vector<double>& freqs)
+{
+  std::vector<BiquadCoefficients> sections;
+  getResponseSections(chainSettings, sampleRate, sections);
+
+  FrequencyResponse response;
+  computeFrequencyResponse(sections, sampleRate, freqs, response);
+  return response;
+}
+
+//==============================================================================
+void
+IncrementalFrequencyResponse::prepare(const std::vector<double>& newFreqs,
+                                      double newSampleRate)
+{
+  freqs = newFreqs;
+  sampleRate = newSampleRate;
+  appliedValid = false;
+
+  const auto numPoints = freqs.size();
+  for (auto* values : { &total.magnitudeDecibels,
+                        &total.phaseRadians,
+                        &total.groupDelaySeconds }) {
+    values->assign(numPoints, 0.f);
+  }
+}
+
+bool
+IncrementalFrequencyResponse::isPreparedFor(int numPoints,
+                                            double newSampleRate) const
+{
+  return (int)freqs.size() == numPoints && sampleRate == newSampleRate;
+}
+
+size_t
+IncrementalFrequencyResponse::getMemoryBytes() const
+{
+  auto getResponseBytes = [](const FrequencyResponse& response) {
+    return ::getMemoryBytes(response.magnitudeDecibels) +
+           ::getMemoryBytes(response.phaseRadians) +
+           ::getMemoryBytes(response.groupDelaySeconds);
+  };
+
+  auto bytes = ::getMemoryBytes(freqs) + ::getMemoryBytes(sections) +
+               getResponseBytes(total);
+  for (const auto& band : bands)
+    bytes += getResponseBytes(band);
+
+  return bytes;
+}
+
+bool
+IncrementalFrequencyResponse::bandChanged(
+  int band,
+  const ChainSettings& chainSettings) const
+{
+  switch (band) {
+    case ChainPositions::LowCut:
+      return !lowCutSettingsMatch(chainSettings, applied);
+    case ChainPositions::Peak:
+      return !peakSettingsMatch(chainSettings, applied);
+    case ChainPositions::HighCut:
+      return !highCutSettingsMatch(chainSettings, applied);
+    default:
+      return chainSettings.bands[band - 3] != applied.bands[band - 3];
+  }
+}
+
+bool
+IncrementalFrequencyResponse::update(const ChainSettings& chainSettings)
+{
+  bool anyChanged = false;
+
+  for (int band = 0; band < NumResponseBands; ++band) {
+    if (appliedValid && !bandChanged(band, chainSettings))
+      continue;
+
+    getBandSections(chainSettings, band, sampleRate, sections);
+    bandIsActive[band] = !sections.empty();
+    if (bandIsActive[band])
+      computeFrequencyResponse(sections, sampleRate, freqs, bands[band]);
+
+    anyChanged = true;
+  }
+
+  applied = chainSettings;
+  appliedValid = true;
+
+  if (anyChanged)
+    sumBands();
+
+  return anyChanged;
+}
+
+void
+IncrementalFrequencyResponse::sumBands()
+{
+  const auto numPoints = (int)freqs.size();
+  auto* mags = total.magnitudeDecibels.data();
+  auto* phases = total.phaseRadians.data();
+  auto* delays = total.groupDelaySeconds.data();
+
+  juce::FloatVectorOperations::clear(mags, numPoints);
+  juce::FloatVectorOperations::clear(phases, numPoints);
+  juce::FloatVectorOperations::clear(delays, numPoints);
+
+  for (int band = 0; band < NumResponseBands; ++band) {
+    if (!bandIsActive[band])
+      continue;
+
+    const auto& response = bands[band];
+    juce::FloatVectorOperations::add(
+      mags, response.magnitudeDecibels.data(), numPoints);
+    juce::FloatVectorOperations::add(
+      phases, response.phaseRadians.data(), numPoints);
+    juce::FloatVectorOperations::add(
+      delays, response.groupDelaySeconds.data(), numPoints);
+  }
+
+  // back to [-pi, pi]
+  const auto pi = juce::MathConstants<float>::pi;
+  const auto twoPi = juce::MathConstants<float>::twoPi;
+  for (int i = 0; i < numPoints; ++i) {
+    phases[i] -= twoPi * std::floor((phases[i] + pi) / twoPi);
+  }
+}
+
+//==============================================================================
+std::vector<FrequencyResponse>
+computeFrequencyResponses(const std::vector<ChainSettings>& settings,
+                          double sampleRate,
+                          const std::vector<double>& freqs,
+                          juce::ThreadPool& pool)
+{
+  std::vector<FrequencyResponse> responses(settings.size());
+  if (settings.empty())
+    return responses;
+
+  // a few jobs per thread, each one a contiguous run of settings, so the
+  // sections and response arrays are reused within a job
+  const auto numJobs =
+    juce::jmin((int)settings.size(), pool.getNumThreads() * 4);
+  const auto perJob = ((int)settings.size() + numJobs - 1) / numJobs;
+
+  std::atomic<int> remaining{ numJobs };
+  juce::WaitableEvent finished;
+
+  for (int job = 0; job < numJobs; ++job) {
+    auto start = job * perJob;
+    auto end = juce::jmin(start + perJob, (int)settings.size());
+
+    pool.addJob([&, start, end] {
+      std::vector<BiquadCoefficients> sections;
+      for (int i = start; i < end; ++i) {
+        getResponseSections(settings[i], sampleRate, sections);
+        computeFrequencyResponse(sections, sampleRate, freqs, responses[i]);
+      }
+
+      if (--remaining == 0)
+        finished.signal();
+
+      return juce::ThreadPoolJob::jobHasFinished;
+    });
+  }
+
+  finished.wait();
+  return responses;
+}
+
+std::vector<double>
+makeLogFrequencyGrid(int numPoints)
+{
+  std::vector<double> freqs((size_t)juce::jmax(numPoints, 0));
+  for (int i = 0; i < numPoints; ++i) {
+    freqs[i] = juce::mapToLog10(
+      numPoints > 1 ? double(i) / double(numPoints - 1) : 0.0, 20.0, 20000.0);
+  }
+  return freqs;
+}
+
+bool
+writeFrequencyResponsesCsv(const juce::File& file,
+                           const std::vector<double>& freqs,
+                           const std::vector<FrequencyResponse>& responses)
+{
+  juce::FileOutputStream stream(file);
+  if (!stream.openedOk())
+    return false;
+
+  stream.setPosition(0);
+  stream.truncate();
+
+  stream << "index,frequency,magnitude_db,phase_rad,group_delay_s\n";
+
+  juce::String line;
+  for (size_t r = 0; r < responses.size(); ++r) {
+    const auto& response = responses[r];
+    for (size_t i = 0; i < freqs.size(); ++i) {
+      line.clear();
+      line << (int)r << "," << freqs[i] << ","
+           << response.magnitudeDecibels[i] << "," << response.phaseRadians[i]
+           << "," << response.groupDelaySeconds[i] << "\n";
+      stream << line;
+    }
+  }
+
+  stream.flush();
+  return stream.getStatus().wasOk();
+}
+
+bool
+writeFrequencyResponsesBinary(const juce::File& file,
+                              const std::vector<double>& freqs,
+                              const std::vector<FrequencyResponse>& responses)
+{
+  juce::FileOutputStream stream(file);
+  if (!stream.openedOk())
+    return false;
+
+  stream.setPosition(0);
+  stream.truncate();
+
+  const juce::uint32 header[] = { 0x52514553, // "SEQR"
+                                  1,
+                                  (juce::uint32)freqs.size(),
+                                  (juce::uint32)responses.size() };
+  for (auto value : header)
+    stream.writeInt((int)value);
+
+  for (auto freq : freqs)
+    stream.writeFloat((float)freq);
+
+  for (const auto& response : responses) {
+    for (const auto* values : { &response.magnitudeDecibels,
+                                &response.phaseRadians,
+                                &response.groupDelaySeconds }) {
+      stream.write(values->data(), values->size() * sizeof(float));
+    }
+  }
+
+  stream.flush();
+  return stream.getStatus().wasOk();
+}
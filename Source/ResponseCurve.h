@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    ResponseCurve.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "PluginProcessor.h"
+
+/* The response of a ChainSettings at each frequency of a grid. Magnitudes are
+   in decibels, phases in radians wrapped to [-pi, pi], and group delays in
+   seconds.
+*/
+struct FrequencyResponse
+{
+  std::vector<float> magnitudeDecibels, phaseRadians, groupDelaySeconds;
+};
+
+// the low cut, peak and high cut, then the extra bands
+constexpr int NumResponseBands = 3 + MultiBandFilter::MaxBands;
+
+// the sections of a single band, none when it is bypassed
+void
+getBandSections(const ChainSettings& chainSettings,
+                int band,
+                double sampleRate,
+                std::vector<BiquadCoefficients>& sections);
+
+// the biquad sections the processor runs for these settings, in order. the
+// cut filters are designed exactly as the processor designs them
+void
+getResponseSections(const ChainSettings& chainSettings,
+                    double sampleRate,
+                    std::vector<BiquadCoefficients>& sections);
+
+// evaluates the sections at each of 'freqs', analytically, with no audio
+// processed
+void
+computeFrequencyResponse(const std::vector<BiquadCoefficients>& sections,
+                         double sampleRate,
+                         const std::vector<double>& freqs,
+                         FrequencyResponse& response);
+
+FrequencyResponse
+computeFrequencyResponse(const ChainSettings& chainSettings,
+                         double sampleRate,
+                         const std::vector<double>& freqs);
+
+/* Keeps the response of each band on a fixed frequency grid, so when one band
+   changes only that band is evaluated again. The total is the sum of the
+   bands' decibels, phases and group delays.
+*/
+struct IncrementalFrequencyResponse
+{
+  // sets the grid, every band is evaluated again on the next update
+  void prepare(const std::vector<double>& newFreqs, double newSampleRate);
+  bool isPreparedFor(int numPoints, double sampleRate) const;
+
+  // returns true if any band changed
+  bool update(const ChainSettings& chainSettings);
+
+  const std::vector<double>& getFrequencies() const { return freqs; }
+  const FrequencyResponse& getResponse() const { return total; }
+
+  size_t getMemoryBytes() const;
+
+private:
+  std::vector<double> freqs;
+  double sampleRate = 0.0;
+
+  std::array<FrequencyResponse, NumResponseBands> bands;
+  std::array<bool, NumResponseBands> bandIsActive{};
+  FrequencyResponse total;
+
+  ChainSettings applied;
+  bool appliedValid = false;
+
+  std::vector<BiquadCoefficients> sections;
+
+  bool bandChanged(int band, const ChainSettings& chainSettings) const;
+  void sumBands();
+};
+
+// evaluates a batch of settings on the pool's threads, blocking until all of
+// them are done
+std::vector<FrequencyResponse>
+computeFrequencyResponses(const std::vector<ChainSettings>& settings,
+                          double sampleRate,
+                          const std::vector<double>& freqs,
+                          juce::ThreadPool& pool);
+
+// 'numPoints' frequencies spaced evenly in log frequency, from 20 Hz to 20 kHz
+std::vector<double>
+makeLogFrequencyGrid(int numPoints);
+
+// one row per response and frequency: index, frequency, magnitude, phase, group
+// delay
+bool
+writeFrequencyResponsesCsv(const juce::File& file,
+                           const std::vector<double>& freqs,
+                           const std::vector<FrequencyResponse>& responses);
+
+/* A little endian header of { magic "SEQR", version, numFrequencies,
+   numResponses } as uint32s, the frequencies as float32s, then the
+   magnitudes, phases and group delays of each response as float32s.
+*/
+bool
+writeFrequencyResponsesBinary(const juce::File& file,
+                              const std::vector<double>& freqs,
+                              const std::vector<FrequencyResponse>& responses);
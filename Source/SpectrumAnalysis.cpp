@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalysis.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalysis.h"
+
+#include <complex>
+
+const juce::dsp::FFT&
+SharedFFTResources::getFFT(FFTOrder order)
+{
+  const juce::ScopedLock sl(lock);
+
+  auto& fft = ffts[order - MinOrder];
+  if (fft == nullptr)
+    fft = std::make_unique<juce::dsp::FFT>(order);
+
+  return *fft;
+}
+
+const juce::dsp::WindowingFunction<float>&
+SharedFFTResources::getWindow(FFTOrder order)
+{
+  const juce::ScopedLock sl(lock);
+
+  auto& window = windows[order - MinOrder];
+  if (window == nullptr) {
+    window = std::make_unique<juce::dsp::WindowingFunction<float>>(
+      size_t(1) << order, juce::dsp::WindowingFunction<float>::blackmanHarris);
+  }
+
+  return *window;
+}
+
+size_t
+SharedFFTResources::getMemoryBytes()
+{
+  const juce::ScopedLock sl(lock);
+
+  // a complex twiddle per point for each plan, and a float per point for each
+  // window
+  size_t bytes = 0;
+  for (int i = 0; i < NumOrders; ++i) {
+    const auto size = size_t(1) << (MinOrder + i);
+    if (ffts[i] != nullptr)
+      bytes += size * sizeof(std::complex<float>);
+    if (windows[i] != nullptr)
+      bytes += size * sizeof(float);
+  }
+
+  return bytes;
+}
+
+//==============================================================================
+void
+computeSpectrum(const float* frame,
+                FFTOrder order,
+                const juce::dsp::FFT& fft,
+                const juce::dsp::WindowingFunction<float>& window,
+                float* workspace,
+                float* decibels,
+                float negativeInfinity)
+{
+  const auto fftSize = 1 << order;
+  const auto numBins = fftSize / 2;
+
+  juce::FloatVectorOperations::copy(workspace, frame, fftSize);
+  juce::FloatVectorOperations::clear(workspace + fftSize, fftSize);
+
+  window.multiplyWithWindowingTable(workspace, (size_t)fftSize);
+  fft.performFrequencyOnlyForwardTransform(workspace);
+
+  // normalize, then convert to decibels
+  juce::FloatVectorOperations::multiply(
+    workspace, 1.f / float(numBins), numBins);
+  for (int bin = 0; bin < numBins; ++bin) {
+    decibels[bin] =
+      juce::Decibels::gainToDecibels(workspace[bin], negativeInfinity);
+  }
+}
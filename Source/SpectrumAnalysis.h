@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalysis.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+
+enum FFTOrder
+{
+  order1024 = 10,
+  order2048 = 11,
+  order4096 = 12,
+  order8192 = 13
+};
+
+/* The FFT plans and windows, one per order, shared by every analyzer in the
+   process through a juce::SharedResourcePointer. Both are only read once made,
+   so sharing them between instances is safe.
+*/
+struct SharedFFTResources
+{
+  const juce::dsp::FFT& getFFT(FFTOrder order);
+  const juce::dsp::WindowingFunction<float>& getWindow(FFTOrder order);
+
+  // an estimate, the FFT engines don't report what their plans hold
+  size_t getMemoryBytes();
+
+private:
+  static constexpr int MinOrder = order1024;
+  static constexpr int NumOrders = order8192 - order1024 + 1;
+
+  juce::CriticalSection lock;
+  std::array<std::unique_ptr<juce::dsp::FFT>, NumOrders> ffts;
+  std::array<std::unique_ptr<juce::dsp::WindowingFunction<float>>, NumOrders>
+    windows;
+};
+
+/* Turns one frame of (1 << order) samples into decibels per bin, the same way
+   the editor's analyzer does: Blackman-Harris window, magnitude FFT,
+   normalised by the number of bins, floored at negativeInfinity.
+   'workspace' needs room for 2 << order floats and 'decibels' for half the
+   frame. On return the workspace starts with the normalised magnitudes.
+   Nothing is allocated, so any thread with its own workspace can call it.
+*/
+void
+computeSpectrum(const float* frame,
+                FFTOrder order,
+                const juce::dsp::FFT& fft,
+                const juce::dsp::WindowingFunction<float>& window,
+                float* workspace,
+                float* decibels,
+                float negativeInfinity);
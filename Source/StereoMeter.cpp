@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    StereoMeter.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "StereoMeter.h"
+
+void
+StereoMeter::prepare(double newSampleRate)
+{
+  sampleRate = newSampleRate;
+  reset();
+}
+
+void
+StereoMeter::reset()
+{
+  meanLL = meanRR = meanLR = 0;
+  peakL = peakR = 0;
+
+  for (int ch = 0; ch < 2; ++ch) {
+    peaks[ch].store(0.f);
+    rmsLevels[ch].store(0.f);
+  }
+  correlation.store(0.f);
+}
+
+void
+StereoMeter::process(const juce::AudioBuffer<float>& buffer)
+{
+  using SIMD = juce::dsp::SIMDRegister<float>;
+
+  const auto numSamples = buffer.getNumSamples();
+  if (numSamples == 0 || buffer.getNumChannels() < 2)
+    return;
+
+  const auto* left = buffer.getReadPointer(0);
+  const auto* right = buffer.getReadPointer(1);
+
+  float sumLL = 0, sumRR = 0, sumLR = 0, maxL = 0, maxR = 0;
+  int i = 0;
+
+  auto processScalar = [&](int end) {
+    for (; i < end; ++i) {
+      auto l = left[i], r = right[i];
+      sumLL += l * l;
+      sumRR += r * r;
+      sumLR += l * r;
+      maxL = juce::jmax(maxL, std::abs(l));
+      maxR = juce::jmax(maxR, std::abs(r));
+    }
+  };
+
+  // the vector loads need both channels aligned, which they are in buffers
+  // juce allocates
+  auto* alignedLeft = SIMD::getNextSIMDAlignedPtr(const_cast<float*>(left));
+  const auto headLength = int(alignedLeft - left);
+
+  if (SIMD::isSIMDAligned(right + headLength)) {
+    processScalar(juce::jmin(headLength, numSamples));
+
+    SIMD vLL(0.f), vRR(0.f), vLR(0.f), vMax(0.f), vMin(0.f), vMaxR(0.f),
+      vMinR(0.f);
+    constexpr auto step = (int)SIMD::size();
+
+    for (; i + step <= numSamples; i += step) {
+      auto l = SIMD::fromRawArray(left + i);
+      auto r = SIMD::fromRawArray(right + i);
+
+      vLL = SIMD::multiplyAdd(vLL, l, l);
+      vRR = SIMD::multiplyAdd(vRR, r, r);
+      vLR = SIMD::multiplyAdd(vLR, l, r);
+      vMax = SIMD::max(vMax, l);
+      vMin = SIMD::min(vMin, l);
+      vMaxR = SIMD::max(vMaxR, r);
+      vMinR = SIMD::min(vMinR, r);
+    }
+
+    sumLL += vLL.sum();
+    sumRR += vRR.sum();
+    sumLR += vLR.sum();
+
+    for (size_t n = 0; n < SIMD::size(); ++n) {
+      maxL = juce::jmax(maxL, vMax[n], -vMin[n]);
+      maxR = juce::jmax(maxR, vMaxR[n], -vMinR[n]);
+    }
+  }
+
+  processScalar(numSamples);
+
+  // one pole smoothing of the mean squares, applied once per block
+  const auto blockSeconds = numSamples / sampleRate;
+  const auto rmsCoeff = std::exp(-blockSeconds / 0.3);
+  meanLL = rmsCoeff * meanLL + (1.0 - rmsCoeff) * (sumLL / numSamples);
+  meanRR = rmsCoeff * meanRR + (1.0 - rmsCoeff) * (sumRR / numSamples);
+  meanLR = rmsCoeff * meanLR + (1.0 - rmsCoeff) * (sumLR / numSamples);
+
+  // peaks fall by 20 dB a second
+  const auto peakFalloff = float(std::pow(10.0, -blockSeconds));
+  peakL = juce::jmax(maxL, peakL * peakFalloff);
+  peakR = juce::jmax(maxR, peakR * peakFalloff);
+
+  peaks[0].store(peakL, std::memory_order_relaxed);
+  peaks[1].store(peakR, std::memory_order_relaxed);
+  rmsLevels[0].store(float(std::sqrt(meanLL)), std::memory_order_relaxed);
+  rmsLevels[1].store(float(std::sqrt(meanRR)), std::memory_order_relaxed);
+
+  const auto energy = std::sqrt(meanLL * meanRR);
+  correlation.store(energy > 1e-10 ? float(meanLR / energy) : 0.f,
+                    std::memory_order_relaxed);
+}
@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    StereoMeter.h
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/* Peak, RMS and correlation of a stereo signal. process() runs on the audio
+   thread, and the results are published through atomics so any thread can
+   read them without locking.
+*/
+struct StereoMeter
+{
+  void prepare(double sampleRate);
+  void reset();
+
+  // reads the first two channels, one SIMD pass over the samples
+  void process(const juce::AudioBuffer<float>& buffer);
+
+  // linear gain, with a peak falloff and a 300 ms RMS window
+  float getPeak(int channel) const { return peaks[channel].load(); }
+  float getRms(int channel) const { return rmsLevels[channel].load(); }
+
+  // -1 for out of phase, 0 for unrelated and 1 for mono
+  float getCorrelation() const { return correlation.load(); }
+
+private:
+  double sampleRate = 44100.0;
+
+  // running mean squares and peaks, only touched on the audio thread
+  double meanLL = 0, meanRR = 0, meanLR = 0;
+  float peakL = 0, peakR = 0;
+
+  std::atomic<float> peaks[2]{ { 0.f }, { 0.f } };
+  std::atomic<float> rmsLevels[2]{ { 0.f }, { 0.f } };
+  std::atomic<float> correlation{ 0.f };
+};
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    ToolHelpers.h
+    Created: 18 Oct 2026
+
+    Command line and setup helpers shared by the console tools that drive a
+    SimpleEqAudioProcessor outside a host.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "../../Source/PluginProcessor.h"
+
+namespace ToolHelpers {
+// fails the run if the option is there but isn't a positive integer
+inline int
+getIntOption(const juce::ArgumentList& args, const char* option, int fallback)
+{
+  if (!args.containsOption(option))
+    return fallback;
+
+  auto value = args.getValueForOption(option).getIntValue();
+  if (value <= 0)
+    juce::ConsoleApplication::fail(juce::String(option) + " must be positive");
+
+  return value;
+}
+
+inline double
+getDoubleOption(const juce::ArgumentList& args,
+                const char* option,
+                double fallback)
+{
+  if (!args.containsOption(option))
+    return fallback;
+
+  return args.getValueForOption(option).getDoubleValue();
+}
+
+inline double
+getMilliseconds()
+{
+  return juce::Time::getMillisecondCounterHiRes();
+}
+
+// 'value' is in the parameter's own units, not normalised
+inline void
+setParameter(SimpleEqAudioProcessor& processor,
+             const juce::String& parameterID,
+             float value)
+{
+  auto* param = processor.apvts.getParameter(parameterID);
+  jassert(param != nullptr);
+  param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+// as a host would before the first block
+inline void
+prepareProcessor(SimpleEqAudioProcessor& processor,
+                 double sampleRate,
+                 int blockSize)
+{
+  processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+  processor.prepareToPlay(sampleRate, blockSize);
+}
+
+inline std::unique_ptr<SimpleEqAudioProcessor>
+makeProcessor(double sampleRate, int blockSize)
+{
+  auto processor = std::make_unique<SimpleEqAudioProcessor>();
+  prepareProcessor(*processor, sampleRate, blockSize);
+  return processor;
+}
+} // namespace ToolHelpers
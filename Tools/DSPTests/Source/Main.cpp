@@ -0,0 +1,774 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026
+
+    Regression tests for the processor's DSP, run outside a host. Each case
+    drives processBlock with an impulse and with sines, and checks the output
+    against a long double reference designed here, without any of the
+    processor's own filter design code. The reference is itself checked
+    against the closed form Butterworth and peak responses. A throughput gate
+    then fails the run if a full chain takes too much of a core. Exits with a
+    non-zero status if anything fails.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "../../../Source/PluginProcessor.h"
+#include "../../Common/ToolHelpers.h"
+
+#include <complex>
+
+namespace {
+using ToolHelpers::getDoubleOption;
+using ToolHelpers::getMilliseconds;
+using ToolHelpers::setParameter;
+
+constexpr int blockSize = 512;
+constexpr float sineAmplitude = 0.5f;
+
+const std::array<double, 3> sampleRates{ 44100.0, 48000.0, 96000.0 };
+const std::array<double, 4> sineFrequencies{ 50.0, 1000.0, 5000.0, 15000.0 };
+
+/* The processor's settings for one case. The side settings are only used in
+   Mid/Side mode, and share the main settings' extra bands.
+*/
+struct TestCase
+{
+  juce::String name;
+  ChainSettings main, side;
+  bool midSide{ false }, bypassed{ false };
+};
+
+// every fixed band bypassed and no extra bands, the processor's defaults
+// otherwise
+ChainSettings
+makeFlatSettings()
+{
+  ChainSettings settings;
+  settings.lowCutFreq = 20.f;
+  settings.highCutFreq = 20000.f;
+  settings.peakFreq = 750.f;
+  settings.lowCutBypassed = true;
+  settings.peakBypassed = true;
+  settings.highCutBypassed = true;
+  return settings;
+}
+
+// switches every extra band in, spread over the spectrum
+void
+addEveryExtraBand(ChainSettings& settings)
+{
+  for (int i = 0; i < MultiBandFilter::MaxBands; ++i) {
+    auto& band = settings.bands[(size_t)i];
+    band.freq = std::round(
+      30.f * std::pow(600.f, float(i) / MultiBandFilter::MaxBands));
+    band.gainInDecibels = i % 2 == 0 ? 3.f : -3.f;
+    band.quality = 4.f;
+    band.bypassed = false;
+  }
+}
+
+// every fixed band in, somewhere in the middle of its range
+ChainSettings
+makeActiveSettings()
+{
+  ChainSettings settings;
+  settings.lowCutFreq = 80.f;
+  settings.lowCutSlope = Slope_24;
+  settings.peakFreq = 1000.f;
+  settings.peakGainInDecibles = 6.f;
+  settings.peakQuality = 1.f;
+  settings.highCutFreq = 12000.f;
+  settings.highCutSlope = Slope_36;
+  return settings;
+}
+
+std::vector<TestCase>
+makeTestCases()
+{
+  std::vector<TestCase> cases;
+
+  auto addCase = [&cases](const juce::String& name,
+                          const ChainSettings& settings) {
+    TestCase test;
+    test.name = name;
+    test.main = test.side = settings;
+    cases.push_back(test);
+  };
+
+  addCase("flat", makeFlatSettings());
+
+  for (int slope = Slope_12; slope <= Slope_48; ++slope) {
+    const auto slopeName = juce::String(12 * (slope + 1)) + " dB/oct";
+
+    for (auto freq : { 20.f, 1000.f, 20000.f }) {
+      auto settings = makeFlatSettings();
+      settings.lowCutBypassed = false;
+      settings.lowCutFreq = freq;
+      settings.lowCutSlope = static_cast<Slope>(slope);
+      addCase("low cut " + juce::String(freq) + " Hz " + slopeName, settings);
+
+      settings = makeFlatSettings();
+      settings.highCutBypassed = false;
+      settings.highCutFreq = freq;
+      settings.highCutSlope = static_cast<Slope>(slope);
+      addCase("high cut " + juce::String(freq) + " Hz " + slopeName, settings);
+    }
+  }
+
+  // each combination of the fixed bands switched in and out
+  for (int mask = 0; mask < 8; ++mask) {
+    auto settings = makeActiveSettings();
+    settings.lowCutBypassed = (mask & 1) != 0;
+    settings.peakBypassed = (mask & 2) != 0;
+    settings.highCutBypassed = (mask & 4) != 0;
+    addCase("fixed bands bypassed " + juce::String(mask), settings);
+  }
+
+  // the corners of the peak's range
+  {
+    auto settings = makeFlatSettings();
+    settings.peakBypassed = false;
+    settings.peakFreq = 20.f;
+    settings.peakGainInDecibles = 24.f;
+    settings.peakQuality = 10.f;
+    addCase("peak 20 Hz +24 dB Q 10", settings);
+
+    settings.peakFreq = 20000.f;
+    settings.peakGainInDecibles = -24.f;
+    settings.peakQuality = 0.1f;
+    addCase("peak 20 kHz -24 dB Q 0.1", settings);
+  }
+
+  for (int type = BandType_Peak; type <= BandType_HighCut; ++type) {
+    auto settings = makeFlatSettings();
+    auto& band = settings.bands[0];
+    band.type = static_cast<BandType>(type);
+    band.freq = 2000.f;
+    band.gainInDecibels = -9.f;
+    band.quality = 2.f;
+    band.bypassed = false;
+    addCase("extra band type " + juce::String(type), settings);
+  }
+
+  {
+    auto settings = makeFlatSettings();
+    addEveryExtraBand(settings);
+    addCase("every extra band", settings);
+  }
+
+  {
+    TestCase test;
+    test.name = "mid/side";
+    test.midSide = true;
+    test.main = makeFlatSettings();
+    test.main.lowCutBypassed = false;
+    test.main.lowCutFreq = 100.f;
+    test.main.lowCutSlope = Slope_24;
+    test.main.peakBypassed = false;
+    test.main.peakFreq = 3000.f;
+    test.main.peakGainInDecibles = 4.f;
+    test.side = makeFlatSettings();
+    test.side.highCutBypassed = false;
+    test.side.highCutFreq = 5000.f;
+    test.side.highCutSlope = Slope_12;
+    test.side.peakBypassed = false;
+    test.side.peakFreq = 300.f;
+    test.side.peakGainInDecibles = -6.f;
+    test.side.peakQuality = 0.5f;
+    cases.push_back(test);
+  }
+
+  {
+    TestCase test;
+    test.name = "global bypass";
+    test.bypassed = true;
+    test.main = test.side = makeActiveSettings();
+    cases.push_back(test);
+  }
+
+  return cases;
+}
+
+std::unique_ptr<SimpleEqAudioProcessor>
+makeProcessor(const TestCase& test, double sampleRate)
+{
+  auto processor = std::make_unique<SimpleEqAudioProcessor>();
+  setChainSettings(processor->apvts, test.main);
+  setChainSettings(processor->apvts, test.side, SideParameters);
+  setParameter(*processor, "Stereo Mode", test.midSide ? 1.f : 0.f);
+  setParameter(*processor, "Bypass", test.bypassed ? 1.f : 0.f);
+
+  ToolHelpers::prepareProcessor(*processor, sampleRate, blockSize);
+  return processor;
+}
+
+//==============================================================================
+constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+// b0, b1, b2, a1, a2 normalised by a0, the order the processor keeps them in
+using ReferenceSection = std::array<long double, 5>;
+
+// the coefficients of s^0, s^1 and s^2 of an analog second order section
+using AnalogPolynomial = std::array<long double, 3>;
+
+/* The bilinear transform of b(s) / a(s), where s is normalised so that 1 is
+   'freq', prewarped so the digital section matches the analog one there.
+*/
+ReferenceSection
+bilinearTransform(const AnalogPolynomial& b,
+                  const AnalogPolynomial& a,
+                  long double freq,
+                  long double sampleRate)
+{
+  // s = k (1 - z^-1) / (1 + z^-1)
+  const auto k = 1.0L / std::tan(pi * freq / sampleRate);
+  const auto kSquared = k * k;
+
+  auto transform = [k, kSquared](const AnalogPolynomial& p) {
+    return std::array<long double, 3>{ p[2] * kSquared + p[1] * k + p[0],
+                                       2.0L * (p[0] - p[2] * kSquared),
+                                       p[2] * kSquared - p[1] * k + p[0] };
+  };
+
+  const auto num = transform(b);
+  const auto den = transform(a);
+  return { num[0] / den[0],
+           num[1] / den[0],
+           num[2] / den[0],
+           den[1] / den[0],
+           den[2] / den[0] };
+}
+
+/* A Butterworth cut of order 2 (slope + 1), one section per conjugate pair of
+   poles. The poles sit on the unit circle at (2k + 1) pi / 2n from the
+   imaginary axis.
+*/
+void
+addReferenceCut(bool isHighCut,
+                long double freq,
+                Slope slope,
+                long double sampleRate,
+                std::vector<ReferenceSection>& sections)
+{
+  const auto order = 2 * (static_cast<int>(slope) + 1);
+
+  for (int k = 0; k < order / 2; ++k) {
+    const auto damping = 2.0L * std::sin((2 * k + 1) * pi / (2.0L * order));
+    const AnalogPolynomial den{ 1.0L, damping, 1.0L };
+    const AnalogPolynomial num = isHighCut ? AnalogPolynomial{ 1.0L, 0, 0 }
+                                           : AnalogPolynomial{ 0, 0, 1.0L };
+    sections.push_back(bilinearTransform(num, den, freq, sampleRate));
+  }
+}
+
+// the analog prototypes of the RBJ audio EQ cookbook
+void
+addReferenceBand(BandType type,
+                 long double freq,
+                 long double gainInDecibels,
+                 long double quality,
+                 long double sampleRate,
+                 std::vector<ReferenceSection>& sections)
+{
+  const auto A = std::pow(10.0L, gainInDecibels / 40.0L);
+  const auto sqrtA = std::sqrt(A);
+  const auto invQ = 1.0L / quality;
+
+  AnalogPolynomial num, den;
+  switch (type) {
+    case BandType_Peak:
+      num = { 1.0L, A * invQ, 1.0L };
+      den = { 1.0L, invQ / A, 1.0L };
+      break;
+    case BandType_LowShelf:
+      num = { A * A, A * sqrtA * invQ, A };
+      den = { 1.0L, sqrtA * invQ, A };
+      break;
+    case BandType_HighShelf:
+      num = { A, A * sqrtA * invQ, A * A };
+      den = { A, sqrtA * invQ, 1.0L };
+      break;
+    case BandType_Notch:
+      num = { 1.0L, 0, 1.0L };
+      den = { 1.0L, invQ, 1.0L };
+      break;
+    case BandType_LowCut:
+      num = { 0, 0, 1.0L };
+      den = { 1.0L, invQ, 1.0L };
+      break;
+    case BandType_HighCut:
+      num = { 1.0L, 0, 0 };
+      den = { 1.0L, invQ, 1.0L };
+      break;
+  }
+
+  sections.push_back(bilinearTransform(num, den, freq, sampleRate));
+}
+
+std::vector<ReferenceSection>
+designReference(const ChainSettings& settings, double sampleRate)
+{
+  std::vector<ReferenceSection> sections;
+
+  if (!settings.lowCutBypassed)
+    addReferenceCut(
+      false, settings.lowCutFreq, settings.lowCutSlope, sampleRate, sections);
+
+  if (!settings.peakBypassed)
+    addReferenceBand(BandType_Peak,
+                     settings.peakFreq,
+                     settings.peakGainInDecibles,
+                     settings.peakQuality,
+                     sampleRate,
+                     sections);
+
+  if (!settings.highCutBypassed)
+    addReferenceCut(
+      true, settings.highCutFreq, settings.highCutSlope, sampleRate, sections);
+
+  for (const auto& band : settings.bands) {
+    if (!band.bypassed)
+      addReferenceBand(band.type,
+                       band.freq,
+                       band.gainInDecibels,
+                       band.quality,
+                       sampleRate,
+                       sections);
+  }
+
+  return sections;
+}
+
+// the processor keeps its coefficients in floats, and near DC a steep cut's
+// response is sensitive to their last bit. the reference is rounded the same
+// way, so the tests compare the designs and not the rounding
+std::vector<ReferenceSection>
+roundToFloat(std::vector<ReferenceSection> sections)
+{
+  for (auto& section : sections) {
+    for (auto& c : section)
+      c = (long double)(float)c;
+  }
+
+  return sections;
+}
+
+long double
+getReferenceDecibels(const std::vector<ReferenceSection>& sections,
+                     long double freq,
+                     long double sampleRate)
+{
+  const auto w = 2.0L * pi * freq / sampleRate;
+  const auto z1 = std::polar(1.0L, -w);
+  const auto z2 = z1 * z1;
+
+  std::complex<long double> response(1.0L);
+  for (const auto& c : sections)
+    response *= (c[0] + c[1] * z1 + c[2] * z2) / (1.0L + c[3] * z1 + c[4] * z2);
+
+  return 20.0L * std::log10(std::abs(response));
+}
+
+/* The transposed direct form II recurrence the processor runs, in long
+   double, so the rounding it adds is far below what the processor's floats
+   add.
+*/
+struct ReferenceCascade
+{
+  explicit ReferenceCascade(const std::vector<ReferenceSection>& s)
+    : sections(s)
+    , states(s.size())
+  {}
+
+  long double process(long double x)
+  {
+    for (size_t i = 0; i < sections.size(); ++i) {
+      const auto& c = sections[i];
+      auto& z = states[i];
+      const long double out = c[0] * x + z[0];
+      z[0] = c[1] * x - c[3] * out + z[1];
+      z[1] = c[2] * x - c[4] * out;
+      x = out;
+    }
+
+    return x;
+  }
+
+  std::vector<ReferenceSection> sections;
+  std::vector<std::array<long double, 2>> states;
+};
+
+/* The sections the processor should be running on each channel, read back
+   from the parameters so they include any snapping to the parameter grids,
+   and rounded to floats as the processor's are.
+*/
+std::array<std::vector<ReferenceSection>, 2>
+getExpectedSections(SimpleEqAudioProcessor& processor,
+                    const TestCase& test,
+                    double sampleRate)
+{
+  std::array<std::vector<ReferenceSection>, 2> sections;
+  if (test.bypassed)
+    return sections;
+
+  const auto main = getChainSettings(processor.apvts);
+  auto second = main;
+  if (test.midSide) {
+    second = getChainSettings(processor.apvts, SideParameters);
+    second.bands = main.bands;
+  }
+
+  sections[0] = roundToFloat(designReference(main, sampleRate));
+  sections[1] = roundToFloat(designReference(second, sampleRate));
+  return sections;
+}
+
+// runs 'input' through the processor a block at a time
+juce::AudioBuffer<float>
+processInBlocks(SimpleEqAudioProcessor& processor,
+                const juce::AudioBuffer<float>& input)
+{
+  auto output = input;
+  juce::MidiBuffer midi;
+
+  for (int start = 0; start < output.getNumSamples(); start += blockSize) {
+    const auto num = juce::jmin(blockSize, output.getNumSamples() - start);
+    juce::AudioBuffer<float> block(
+      output.getArrayOfWritePointers(), output.getNumChannels(), start, num);
+    processor.processBlock(block, midi);
+  }
+
+  return output;
+}
+
+// what the processor should output for 'input', computed sample by sample
+std::array<std::vector<long double>, 2>
+processReference(const std::array<std::vector<ReferenceSection>, 2>& sections,
+                 bool midSide,
+                 const juce::AudioBuffer<float>& input)
+{
+  ReferenceCascade first(sections[0]), second(sections[1]);
+  const auto* left = input.getReadPointer(0);
+  const auto* right = input.getReadPointer(1);
+
+  std::array<std::vector<long double>, 2> output;
+  for (int i = 0; i < input.getNumSamples(); ++i) {
+    if (midSide) {
+      const auto mid = first.process(0.5L * (left[i] + right[i]));
+      const auto side = second.process(0.5L * (left[i] - right[i]));
+      output[0].push_back(mid + side);
+      output[1].push_back(mid - side);
+    } else {
+      output[0].push_back(first.process(left[i]));
+      output[1].push_back(second.process(right[i]));
+    }
+  }
+
+  return output;
+}
+
+struct Failures
+{
+  void check(bool ok, const juce::String& what)
+  {
+    if (!ok) {
+      ++count;
+      std::cout << "FAIL: " << what << std::endl;
+    }
+  }
+
+  int count = 0;
+};
+
+/* An impulse on the left and a smaller, later one on the right, so in Mid/Side
+   mode the side chain is driven too. The output has to match the reference
+   sample for sample, within 'tolerance' of the impulse's height.
+*/
+void
+testImpulse(const TestCase& test,
+            double sampleRate,
+            double tolerance,
+            Failures& failures)
+{
+  auto processor = makeProcessor(test, sampleRate);
+  const auto sections = getExpectedSections(*processor, test, sampleRate);
+
+  juce::AudioBuffer<float> input(2, juce::roundToInt(sampleRate));
+  input.clear();
+  input.setSample(0, 0, 1.f);
+  input.setSample(1, 7, 0.5f);
+
+  const auto output = processInBlocks(*processor, input);
+  const auto expected = processReference(sections, test.midSide, input);
+
+  for (int ch = 0; ch < 2; ++ch) {
+    const auto* samples = output.getReadPointer(ch);
+    const auto& reference = expected[(size_t)ch];
+    long double maxError = 0;
+    for (int i = 0; i < output.getNumSamples(); ++i) {
+      maxError = juce::jmax(
+        maxError, std::abs((long double)samples[i] - reference[(size_t)i]));
+    }
+
+    failures.check(maxError <= tolerance,
+                   test.name + " at " + juce::String(sampleRate) +
+                     " Hz: impulse on channel " + juce::String(ch) +
+                     " is off by " + juce::String((double)maxError));
+  }
+}
+
+/* The same sine on both channels, so the side is silent in Mid/Side mode. Once
+   the filters have settled, the output level has to match the reference's
+   response within 'toleranceDecibels'. Besides the fixed frequencies, each
+   cut is measured at its cutoff. Levels far below the input are only checked
+   to stay below the floor.
+*/
+void
+testSines(const TestCase& test,
+          double sampleRate,
+          double toleranceDecibels,
+          Failures& failures)
+{
+  constexpr double floorDecibels = -60.0;
+
+  std::vector<double> freqs(sineFrequencies.begin(), sineFrequencies.end());
+  if (!test.main.lowCutBypassed)
+    freqs.push_back(test.main.lowCutFreq);
+  if (!test.main.highCutBypassed)
+    freqs.push_back(test.main.highCutFreq);
+
+  for (auto freq : freqs) {
+    if (freq >= sampleRate * 0.45)
+      continue;
+
+    auto processor = makeProcessor(test, sampleRate);
+    const auto sections = getExpectedSections(*processor, test, sampleRate);
+
+    const auto expectedDecibels =
+      (double)getReferenceDecibels(sections[0], freq, sampleRate);
+
+    juce::AudioBuffer<float> input(2, juce::roundToInt(sampleRate));
+    for (int i = 0; i < input.getNumSamples(); ++i) {
+      const auto phase =
+        juce::MathConstants<double>::twoPi * freq * i / sampleRate;
+      const auto x = sineAmplitude * std::sin(phase);
+      input.setSample(0, i, (float)x);
+      input.setSample(1, i, (float)x);
+    }
+
+    const auto output = processInBlocks(*processor, input);
+
+    // the last quarter second, long after the lowest cut has settled
+    const auto settled = input.getNumSamples() / 4;
+    const auto start = input.getNumSamples() - settled;
+
+    for (int ch = 0; ch < 2; ++ch) {
+      const auto measuredDecibels = juce::Decibels::gainToDecibels(
+        output.getRMSLevel(ch, start, settled) /
+          input.getRMSLevel(ch, start, settled),
+        -200.f);
+
+      const auto what = test.name + " at " + juce::String(sampleRate) +
+                        " Hz: " + juce::String(freq) + " Hz on channel " +
+                        juce::String(ch) + " measured " +
+                        juce::String(measuredDecibels, 3) + " dB, expected " +
+                        juce::String(expectedDecibels, 3) + " dB";
+
+      if (expectedDecibels < floorDecibels)
+        failures.check(measuredDecibels < floorDecibels + toleranceDecibels,
+                       what);
+      else
+        failures.check(std::abs(measuredDecibels - expectedDecibels) <=
+                         toleranceDecibels,
+                       what);
+    }
+  }
+}
+
+/* Checks the reference itself against closed forms, before it is trusted with
+   the processor. A Butterworth cut of order n is down 10 log10(1 + r^2n) dB,
+   where r is the ratio of the prewarped frequencies, so 3.01 dB at its cutoff
+   and close to 6n dB an octave past it. An RBJ peak has exactly its gain at
+   its centre frequency.
+*/
+void
+testReferenceDesign(Failures& failures)
+{
+  constexpr long double toleranceDecibels = 1e-6L;
+
+  for (auto sampleRate : sampleRates) {
+    for (int slope = Slope_12; slope <= Slope_48; ++slope) {
+      const auto order = 2 * (slope + 1);
+
+      for (auto isHighCut : { false, true }) {
+        for (auto cutoff : { 20.0, 1000.0, 20000.0 }) {
+          std::vector<ReferenceSection> sections;
+          addReferenceCut(isHighCut,
+                          cutoff,
+                          static_cast<Slope>(slope),
+                          sampleRate,
+                          sections);
+
+          for (auto freq : { cutoff / 2, cutoff, cutoff * 2 }) {
+            if (freq >= sampleRate * 0.49)
+              continue;
+
+            auto ratio = std::tan(pi * freq / sampleRate) /
+                         std::tan(pi * cutoff / sampleRate);
+            if (!isHighCut)
+              ratio = 1.0L / ratio;
+
+            const auto expected =
+              -10.0L * std::log10(1.0L + std::pow(ratio, 2.0L * order));
+            const auto measured =
+              getReferenceDecibels(sections, freq, sampleRate);
+
+            failures.check(
+              std::abs(measured - expected) <= toleranceDecibels,
+              juce::String("reference ") + (isHighCut ? "high" : "low") +
+                " cut " + juce::String(cutoff) + " Hz order " +
+                juce::String(order) + " at " + juce::String(sampleRate) +
+                " Hz: " + juce::String((double)measured, 6) + " dB at " +
+                juce::String(freq) + " Hz, expected " +
+                juce::String((double)expected, 6) + " dB");
+          }
+        }
+      }
+    }
+
+    for (auto freq : { 20.0, 1000.0, 20000.0 }) {
+      for (auto gain : { -24.0, 6.0, 24.0 }) {
+        for (auto quality : { 0.1, 1.0, 10.0 }) {
+          std::vector<ReferenceSection> sections;
+          addReferenceBand(
+            BandType_Peak, freq, gain, quality, sampleRate, sections);
+
+          const auto measured =
+            getReferenceDecibels(sections, freq, sampleRate);
+
+          failures.check(std::abs(measured - gain) <= toleranceDecibels,
+                         "reference peak " + juce::String(freq) + " Hz " +
+                           juce::String(gain) + " dB Q " +
+                           juce::String(quality) + " at " +
+                           juce::String(sampleRate) + " Hz: " +
+                           juce::String((double)measured, 6) +
+                           " dB at its centre");
+        }
+      }
+    }
+  }
+}
+
+/* A full chain: both cuts at their steepest, the peak, and every extra band,
+   processing noise at 48 kHz. Fails if it takes more than 'maxCpuPercent' of
+   a core.
+*/
+void
+testThroughput(double maxCpuPercent, Failures& failures)
+{
+  constexpr double sampleRate = 48000.0;
+  constexpr int seconds = 10;
+
+  TestCase test;
+  test.main = makeActiveSettings();
+  test.main.lowCutSlope = test.main.highCutSlope = Slope_48;
+  addEveryExtraBand(test.main);
+  test.side = test.main;
+
+  auto processor = makeProcessor(test, sampleRate);
+
+  juce::Random random(1);
+  juce::AudioBuffer<float> noise(2, blockSize);
+  for (int ch = 0; ch < 2; ++ch) {
+    for (int i = 0; i < blockSize; ++i)
+      noise.setSample(ch, i, 0.25f * (random.nextFloat() * 2.f - 1.f));
+  }
+
+  const auto numBlocks = juce::roundToInt(seconds * sampleRate / blockSize);
+  juce::AudioBuffer<float> block(2, blockSize);
+  juce::MidiBuffer midi;
+
+  double elapsedMs = 0.0;
+  for (int i = 0; i < numBlocks; ++i) {
+    block.makeCopyOf(noise, true);
+    const auto start = getMilliseconds();
+    processor->processBlock(block, midi);
+    elapsedMs += getMilliseconds() - start;
+  }
+
+  const auto cpuPercent = 100.0 * elapsedMs / (seconds * 1000.0);
+  std::cout << "Full chain at 48 kHz: " << juce::String(cpuPercent, 2)
+            << "% of a core (limit " << maxCpuPercent << "%)" << std::endl;
+
+  failures.check(cpuPercent <= maxCpuPercent,
+                 "the full chain took " + juce::String(cpuPercent, 2) +
+                   "% of a core");
+}
+
+void
+runTests(const juce::ArgumentList& args)
+{
+  const auto impulseTolerance = juce::Decibels::decibelsToGain(
+    getDoubleOption(args, "--tolerance-db", -60.0));
+  const auto sineToleranceDecibels =
+    getDoubleOption(args, "--sine-tolerance-db", 0.05);
+  const auto maxCpuPercent = getDoubleOption(args, "--max-cpu-percent", 5.0);
+
+  Failures failures;
+  testReferenceDesign(failures);
+
+  int numRuns = 0;
+
+  for (const auto& test : makeTestCases()) {
+    for (auto sampleRate : sampleRates) {
+      testImpulse(test, sampleRate, impulseTolerance, failures);
+      testSines(test, sampleRate, sineToleranceDecibels, failures);
+      ++numRuns;
+    }
+  }
+
+  std::cout << numRuns << " cases run" << std::endl;
+
+  if (!args.containsOption("--skip-throughput"))
+    testThroughput(maxCpuPercent, failures);
+
+  if (failures.count > 0)
+    juce::ConsoleApplication::fail(juce::String(failures.count) +
+                                   " checks failed");
+
+  std::cout << "All checks passed" << std::endl;
+}
+} // namespace
+
+//==============================================================================
+int
+main(int argc, char* argv[])
+{
+  // the processor's parameters expect a message manager
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+  juce::ConsoleApplication app;
+
+  app.addHelpCommand("--help|-h", "DSPTests", false);
+  app.addDefaultCommand(
+    { "--run",
+      "--run [--tolerance-db -60] [--sine-tolerance-db 0.05] "
+      "[--max-cpu-percent 5] [--skip-throughput]",
+      "Runs the DSP regression tests and the throughput gate",
+      "Drives processBlock with impulses and sines for every slope, cut "
+      "frequency, fixed band combination, extra band type, Mid/Side and the "
+      "global bypass, at 44.1, 48 and 96 kHz. Impulses must match an "
+      "independently designed long double reference within --tolerance-db of "
+      "their height, and settled sines its response within "
+      "--sine-tolerance-db. The reference is first checked against the closed "
+      "form Butterworth and peak responses. Then fails if a full chain takes "
+      "more than --max-cpu-percent of a core at 48 kHz.",
+      runTests });
+
+  return app.findAndRunCommand(argc, argv);
+}
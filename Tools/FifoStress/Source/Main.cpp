@@ -0,0 +1,386 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026
+
+    Stress tests for the analyzer fifos, run outside a host. A producer thread
+    stands in for the audio thread and a consumer thread for the editor's
+    timer, each at randomized rates and block sizes. Everything pushed is
+    stamped with a sequence number, so the consumer can check the order, catch
+    slots that were overwritten while being read, and count what was dropped.
+    Exits with a non-zero status if anything arrives torn or out of order.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "../../../Source/PluginProcessor.h"
+#include "../../Common/ToolHelpers.h"
+
+#include <thread>
+
+namespace {
+using ToolHelpers::getIntOption;
+using ToolHelpers::getMilliseconds;
+
+using BlockType = SimpleEqAudioProcessor::BlockType;
+
+constexpr double sampleRate = 48000.0;
+constexpr int hopSize = SingleChannelSampleFifo<BlockType>::DefaultHopSize;
+
+// stamps are stored in floats, which hold integers exactly up to 2^24
+constexpr juce::uint32 stampMask = (1u << 24) - 1;
+
+// the push times are kept for this many stamps, far more than are pushed
+// while one waits to be pulled, even at a hundred times real time
+constexpr juce::uint32 numPushTimes = 1u << 14;
+
+// the distance from one stamp to the next, allowing for the wrap
+juce::uint32
+getStampDistance(juce::uint32 from, juce::uint32 to)
+{
+  return (to - from) & stampMask;
+}
+
+/* How the two threads behave. The producer delivers blocks of random sizes at
+   'producerSpeed' times real time. The
+   consumer wakes at random intervals and pulls everything that is ready, and
+   now and then stalls, like a message thread busy with something else.
+*/
+struct Scenario
+{
+  juce::String name;
+  double producerSpeed;
+  int minBlockSize, maxBlockSize;
+  int minPullIntervalMs, maxPullIntervalMs;
+  float stallProbability;
+  int maxStallMs;
+};
+
+const std::array<Scenario, 3> scenarios{ {
+  { "60 Hz editor", 1.0, 32, 1024, 8, 25, 0.f, 0 },
+  { "stalling editor", 1.0, 32, 1024, 8, 25, 0.02f, 250 },
+  { "100x real time", 100.0, 1, 2048, 0, 2, 0.f, 0 },
+} };
+
+// around the compact budget's 8 and the default
+const std::array<int, 5> capacities{
+  4, 8, 16, Fifo<BlockType>::DefaultCapacity, 64
+};
+
+struct StressResult
+{
+  juce::int64 numPushed = 0, numDropped = 0, numPulled = 0;
+  juce::int64 numMissing = 0, numTorn = 0, numOutOfOrder = 0;
+  double seconds = 0.0;
+  std::vector<double> latenciesMs;
+
+  bool passed() const
+  {
+    return numTorn == 0 && numOutOfOrder == 0 && numMissing == numDropped;
+  }
+};
+
+void
+sleepFor(double milliseconds)
+{
+  if (milliseconds > 0.0)
+    std::this_thread::sleep_for(
+      std::chrono::duration<double, std::milli>(milliseconds));
+}
+
+/* Runs 'produce' and 'consume' on their own threads for 'seconds'. 'produce'
+   is handed a block size and returns once it has delivered it, 'consume'
+   pulls everything that is ready. The consumer drains the fifo once the
+   producer has stopped, so every stamp is accounted for.
+*/
+template<typename Produce, typename Consume>
+double
+runThreads(const Scenario& scenario,
+           double seconds,
+           Produce&& produce,
+           Consume&& consume)
+{
+  std::atomic<bool> producerDone{ false };
+  const auto start = getMilliseconds();
+
+  std::thread producer([&] {
+    juce::Random random(1);
+    double samplesProduced = 0.0;
+
+    while (getMilliseconds() - start < seconds * 1000.0) {
+      const auto blockSize = random.nextInt(
+        { scenario.minBlockSize, scenario.maxBlockSize + 1 });
+      produce(blockSize);
+      samplesProduced += blockSize;
+
+      // keeps to the sample clock on average, with the jitter of the sizes
+      const auto due = start + 1000.0 * samplesProduced /
+                                 (sampleRate * scenario.producerSpeed);
+      sleepFor(due - getMilliseconds());
+    }
+
+    producerDone.store(true);
+  });
+
+  std::thread consumer([&] {
+    juce::Random random(2);
+
+    while (!producerDone.load()) {
+      sleepFor(random.nextInt(
+        { scenario.minPullIntervalMs, scenario.maxPullIntervalMs + 1 }));
+
+      if (random.nextFloat() < scenario.stallProbability)
+        sleepFor(random.nextInt(scenario.maxStallMs + 1));
+
+      consume();
+    }
+
+    consume();
+  });
+
+  producer.join();
+  consumer.join();
+
+  return (getMilliseconds() - start) / 1000.0;
+}
+
+/* Fifo<T> on its own, one push per producer block. Every element of a slot
+   holds the block's stamp, so a slot overwritten while it was read shows up
+   as a mix of two stamps.
+*/
+StressResult
+stressFifo(const Scenario& scenario, int capacity, double seconds)
+{
+  using Slot = std::vector<float>;
+
+  Fifo<Slot> fifo;
+  fifo.prepare((size_t)hopSize, capacity);
+
+  std::vector<std::atomic<double>> pushTimes(numPushTimes);
+  StressResult result;
+  result.latenciesMs.reserve(1 << 20);
+
+  Slot pushed((size_t)hopSize), pulled((size_t)hopSize);
+  juce::uint32 nextStamp = 0, lastStamp = stampMask;
+
+  auto produce = [&](int) {
+    const auto stamp = nextStamp++ & stampMask;
+    std::fill(pushed.begin(), pushed.end(), (float)stamp);
+    pushTimes[stamp % numPushTimes].store(getMilliseconds());
+
+    ++result.numPushed;
+    if (!fifo.push(pushed))
+      ++result.numDropped;
+  };
+
+  auto consume = [&] {
+    while (fifo.pull(pulled)) {
+      const auto now = getMilliseconds();
+      const auto stamp = (juce::uint32)pulled.front();
+      ++result.numPulled;
+
+      if (std::any_of(pulled.begin(), pulled.end(), [&](float x) {
+            return x != pulled.front();
+          }))
+        ++result.numTorn;
+
+      const auto distance = getStampDistance(lastStamp, stamp);
+      if (distance == 0 || distance > stampMask / 2)
+        ++result.numOutOfOrder;
+      else
+        result.numMissing += distance - 1;
+
+      lastStamp = stamp;
+      result.latenciesMs.push_back(now -
+                                   pushTimes[stamp % numPushTimes].load());
+    }
+  };
+
+  result.seconds = runThreads(scenario, seconds, produce, consume);
+
+  // drops at the very end leave no gap behind them
+  result.numMissing += getStampDistance(lastStamp, nextStamp - 1);
+  return result;
+}
+
+/* SingleChannelSampleFifo fed blocks of a running sample count. Each hop has
+   to continue the count without a break, start on a hop boundary, and come
+   after the hop before it. Its own drop count has to match the hops that
+   never arrived.
+*/
+StressResult
+stressSampleFifo(const Scenario& scenario, int capacity, double seconds)
+{
+  SingleChannelSampleFifo<BlockType> fifo(Channel::Left);
+  fifo.prepare(hopSize, capacity);
+
+  std::vector<std::atomic<double>> pushTimes(numPushTimes);
+  StressResult result;
+  result.latenciesMs.reserve(1 << 20);
+
+  BlockType block(2, scenario.maxBlockSize), pulled(1, hopSize);
+  juce::uint64 sampleCount = 0;
+
+  // the stamps go up a hop at a time
+  const auto hopStampMask = stampMask / (juce::uint32)hopSize;
+  juce::uint32 lastHop = hopStampMask;
+
+  auto produce = [&](int blockSize) {
+    block.setSize(2, blockSize, false, false, true);
+    for (int i = 0; i < blockSize; ++i) {
+      const auto stamp = (float)((sampleCount + (juce::uint64)i) & stampMask);
+      block.setSample(0, i, stamp);
+      block.setSample(1, i, stamp);
+    }
+
+    // each hop this block completes is timed from the moment it's handed over
+    const auto now = getMilliseconds();
+    const auto firstHop = sampleCount / hopSize;
+    const auto endHop = (sampleCount + (juce::uint64)blockSize) / hopSize;
+    for (auto hop = firstHop; hop < endHop; ++hop)
+      pushTimes[hop % numPushTimes].store(now);
+
+    result.numPushed += (juce::int64)(endHop - firstHop);
+    sampleCount += (juce::uint64)blockSize;
+    fifo.update(block);
+  };
+
+  auto consume = [&] {
+    while (fifo.getAudioBuffer(pulled)) {
+      const auto now = getMilliseconds();
+      const auto* samples = pulled.getReadPointer(0);
+      const auto first = (juce::uint32)samples[0];
+      ++result.numPulled;
+
+      bool torn = first % hopSize != 0;
+      for (int i = 1; i < hopSize && !torn; ++i)
+        torn = (juce::uint32)samples[i] != ((first + i) & stampMask);
+
+      if (torn) {
+        ++result.numTorn;
+        continue;
+      }
+
+      const auto hop = first / hopSize;
+      const auto distance = (hop - lastHop) & hopStampMask;
+      if (distance == 0 || distance > hopStampMask / 2)
+        ++result.numOutOfOrder;
+      else
+        result.numMissing += distance - 1;
+
+      lastHop = hop;
+      result.latenciesMs.push_back(now - pushTimes[hop % numPushTimes].load());
+    }
+  };
+
+  result.seconds = runThreads(scenario, seconds, produce, consume);
+
+  const auto lastHopPushed = (juce::uint32)(sampleCount / hopSize) - 1;
+  result.numMissing += (lastHopPushed - lastHop) & hopStampMask;
+
+  result.numDropped = fifo.getNumDroppedHops();
+  return result;
+}
+
+double
+getPercentile(std::vector<double> values, double percentile)
+{
+  if (values.empty())
+    return 0.0;
+
+  auto index = (size_t)juce::jlimit(
+    0.0, (double)values.size() - 1, percentile / 100.0 * (values.size() - 1));
+  std::nth_element(
+    values.begin(), values.begin() + (std::ptrdiff_t)index, values.end());
+  return values[index];
+}
+
+void
+printResult(const juce::String& fifoName,
+            const Scenario& scenario,
+            int capacity,
+            const StressResult& result)
+{
+  const auto dropPercent =
+    result.numPushed > 0 ? 100.0 * result.numDropped / result.numPushed : 0.0;
+
+  std::cout << fifoName.paddedRight(' ', 24)
+            << scenario.name.paddedRight(' ', 18)
+            << juce::String(capacity).paddedLeft(' ', 4)
+            << juce::String(juce::roundToInt(result.numPushed / result.seconds))
+                 .paddedLeft(' ', 12)
+            << " /s" << juce::String(dropPercent, 2).paddedLeft(' ', 8) << "%"
+            << juce::String(getPercentile(result.latenciesMs, 50.0), 2)
+                 .paddedLeft(' ', 9)
+            << juce::String(getPercentile(result.latenciesMs, 99.0), 2)
+                 .paddedLeft(' ', 9)
+            << juce::String(getPercentile(result.latenciesMs, 100.0), 2)
+                 .paddedLeft(' ', 9)
+            << " ms" << (result.passed() ? "" : "  FAIL") << std::endl;
+
+  if (!result.passed()) {
+    std::cout << "  torn " << result.numTorn << ", out of order "
+              << result.numOutOfOrder << ", missing " << result.numMissing
+              << ", dropped " << result.numDropped << std::endl;
+  }
+}
+
+void
+runStress(const juce::ArgumentList& args)
+{
+  const auto seconds = (double)getIntOption(args, "--seconds", 2);
+
+  std::cout << juce::String("Fifo").paddedRight(' ', 24)
+            << juce::String("Scenario").paddedRight(' ', 18)
+            << juce::String("Cap").paddedLeft(' ', 4)
+            << juce::String("Pushed").paddedLeft(' ', 15)
+            << juce::String("Dropped").paddedLeft(' ', 9)
+            << juce::String("Wait p50").paddedLeft(' ', 9)
+            << juce::String("p99").paddedLeft(' ', 9)
+            << juce::String("max").paddedLeft(' ', 9) << std::endl;
+
+  int numFailed = 0;
+  for (const auto& scenario : scenarios) {
+    for (auto capacity : capacities) {
+      auto result = stressFifo(scenario, capacity, seconds);
+      printResult("Fifo<std::vector<float>>", scenario, capacity, result);
+      numFailed += result.passed() ? 0 : 1;
+
+      result = stressSampleFifo(scenario, capacity, seconds);
+      printResult("SingleChannelSampleFifo", scenario, capacity, result);
+      numFailed += result.passed() ? 0 : 1;
+    }
+  }
+
+  if (numFailed > 0)
+    juce::ConsoleApplication::fail(juce::String(numFailed) + " runs failed");
+}
+} // namespace
+
+//==============================================================================
+int
+main(int argc, char* argv[])
+{
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+  juce::ConsoleApplication app;
+
+  app.addHelpCommand("--help|-h", "FifoStress", false);
+  app.addDefaultCommand(
+    { "--run",
+      "--run [--seconds 2]",
+      "Stresses the analyzer fifos and sweeps their capacity",
+      "Runs a producer and a consumer thread over Fifo<T> and "
+      "SingleChannelSampleFifo, at real time with a steady and a stalling "
+      "consumer and at a hundred times real time, for several capacities "
+      "including the default and the compact budget's. Reports the slots "
+      "pushed a second, the share dropped because the fifo was full, and how "
+      "long slots waited to be pulled. Fails if anything arrives torn or out "
+      "of order, or the drops counted don't match the gaps.",
+      runStress });
+
+  return app.findAndRunCommand(argc, argv);
+}
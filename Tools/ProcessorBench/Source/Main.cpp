@@ -0,0 +1,678 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026
+
+    Benchmarks for the processor, run outside a host. Each command builds its
+    own SimpleEqAudioProcessor, measures one thing and prints the result.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "../../../Source/OfflineRenderer.h"
+#include "../../../Source/PluginEditor.h"
+#include "../../../Source/PluginProcessor.h"
+#include "../../Common/ToolHelpers.h"
+
+namespace {
+using ToolHelpers::getIntOption;
+using ToolHelpers::getMilliseconds;
+using ToolHelpers::makeProcessor;
+using ToolHelpers::setParameter;
+
+constexpr double defaultSampleRate = 48000.0;
+constexpr int defaultBlockSize = 512;
+
+void
+randomiseParameters(juce::AudioProcessor& processor, juce::Random& random)
+{
+  for (auto* param : processor.getParameters())
+    param->setValueNotifyingHost(random.nextFloat());
+}
+
+// white noise at -12 dBFS, so the processor never goes to sleep
+juce::AudioBuffer<float>
+makeNoise(int numChannels, int numSamples, juce::Random& random)
+{
+  juce::AudioBuffer<float> noise(numChannels, numSamples);
+  for (int ch = 0; ch < numChannels; ++ch) {
+    auto* samples = noise.getWritePointer(ch);
+    for (int i = 0; i < numSamples; ++i)
+      samples[i] = 0.25f * (random.nextFloat() * 2.f - 1.f);
+  }
+
+  return noise;
+}
+
+std::vector<float>
+getParameterValues(const juce::AudioProcessor& processor)
+{
+  std::vector<float> values;
+  for (auto* param : processor.getParameters())
+    values.push_back(param->getValue());
+
+  return values;
+}
+
+//==============================================================================
+/* Saves and restores the binary state, and the ValueTree state it replaced
+   for comparison. Restores alternate between two states so every one changes
+   every parameter.
+*/
+void
+benchState(const juce::ArgumentList& args)
+{
+  const auto iterations = getIntOption(args, "--iterations", 10000);
+
+  auto processor = makeProcessor(defaultSampleRate, defaultBlockSize);
+  juce::Random random(1);
+
+  std::array<juce::MemoryBlock, 2> states;
+  std::array<std::vector<float>, 2> values;
+  for (int i = 0; i < 2; ++i) {
+    randomiseParameters(*processor, random);
+    processor->getStateInformation(states[i]);
+    values[i] = getParameterValues(*processor);
+  }
+
+  // a round trip has to reproduce every value before the timings mean much
+  for (int i = 0; i < 2; ++i) {
+    processor->setStateInformation(states[i].getData(),
+                                   (int)states[i].getSize());
+    auto restored = getParameterValues(*processor);
+
+    for (size_t p = 0; p < restored.size(); ++p) {
+      if (std::abs(restored[p] - values[i][p]) > 1e-5f)
+        juce::ConsoleApplication::fail(
+          "Restoring the state changed " +
+          processor->getParameters()[(int)p]->getName(64));
+    }
+  }
+
+  juce::MemoryBlock saved;
+  auto start = getMilliseconds();
+  for (int i = 0; i < iterations; ++i)
+    processor->getStateInformation(saved);
+  const auto saveMs = (getMilliseconds() - start) / iterations;
+
+  start = getMilliseconds();
+  for (int i = 0; i < iterations; ++i) {
+    const auto& state = states[i % 2];
+    processor->setStateInformation(state.getData(), (int)state.getSize());
+  }
+  const auto restoreMs = (getMilliseconds() - start) / iterations;
+
+  std::array<juce::MemoryBlock, 2> trees;
+  for (int i = 0; i < 2; ++i) {
+    processor->setStateInformation(states[i].getData(),
+                                   (int)states[i].getSize());
+    juce::MemoryOutputStream stream(trees[i], false);
+    processor->apvts.copyState().writeToStream(stream);
+  }
+
+  juce::MemoryBlock tree;
+  start = getMilliseconds();
+  for (int i = 0; i < iterations; ++i) {
+    tree.reset();
+    juce::MemoryOutputStream stream(tree, false);
+    processor->apvts.copyState().writeToStream(stream);
+  }
+  const auto treeSaveMs = (getMilliseconds() - start) / iterations;
+
+  start = getMilliseconds();
+  for (int i = 0; i < iterations; ++i) {
+    const auto& state = trees[i % 2];
+    processor->apvts.replaceState(
+      juce::ValueTree::readFromData(state.getData(), state.getSize()));
+  }
+  const auto treeRestoreMs = (getMilliseconds() - start) / iterations;
+
+  std::cout << processor->getParameters().size() << " parameters, "
+            << iterations << " iterations\n"
+            << "  binary:    " << saved.getSize() << " bytes, save "
+            << saveMs * 1000.0 << " us, restore " << restoreMs * 1000.0
+            << " us\n"
+            << "  ValueTree: " << tree.getSize() << " bytes, save "
+            << treeSaveMs * 1000.0 << " us, restore "
+            << treeRestoreMs * 1000.0 << " us\n";
+}
+
+//==============================================================================
+enum AutomationMode
+{
+  AutomationMode_None,
+  AutomationMode_PeakSweep,
+  AutomationMode_Morph,
+};
+
+// a low cut, a peak and four extra bands, so there's plenty to redesign
+void
+setUpAutomationSettings(SimpleEqAudioProcessor& processor)
+{
+  setParameter(processor, "LowCut Freq", 80.f);
+  setParameter(processor, "Peak Gain", 6.f);
+  setParameter(processor, "Peak Quality", 2.f);
+
+  const auto& bandIDs = getBandParameterIDs();
+  for (int i = 0; i < 4; ++i) {
+    setParameter(processor, bandIDs[i].gain, i % 2 == 0 ? 3.f : -3.f);
+    setParameter(processor, bandIDs[i].bypassed, 0.f);
+  }
+
+  auto a = getChainSettings(processor.apvts);
+  auto b = a;
+  b.peakFreq = 4000.f;
+  b.peakGainInDecibles = -6.f;
+  b.lowCutFreq = 200.f;
+  for (int i = 0; i < 4; ++i)
+    b.bands[i].freq *= 2.f;
+
+  processor.setMorphSnapshot(0, a);
+  processor.setMorphSnapshot(1, b);
+}
+
+/* Processes noise while a parameter is automated on every block, the way a
+   host plays back dense automation, and compares the cost against the same
+   settings held still.
+*/
+void
+benchAutomation(const juce::ArgumentList& args)
+{
+  const auto seconds = getIntOption(args, "--seconds", 10);
+  const auto numSamples = juce::roundToInt(seconds * defaultSampleRate);
+
+  juce::Random random(1);
+  const auto noise = makeNoise(2, numSamples, random);
+
+  const char* modeNames[] = { "static", "peak sweep", "morph sweep" };
+
+  std::cout << seconds << " s of noise at " << defaultSampleRate
+            << " Hz, automation at 2 Hz set once per block\n";
+
+  for (auto blockSize : { 64, 256, 1024 }) {
+    for (auto mode : { AutomationMode_None,
+                       AutomationMode_PeakSweep,
+                       AutomationMode_Morph }) {
+      auto processor = makeProcessor(defaultSampleRate, blockSize);
+      setUpAutomationSettings(*processor);
+      setParameter(*processor, "Morph Enabled", mode == AutomationMode_Morph);
+
+      juce::AudioBuffer<float> buffer(2, blockSize);
+      juce::MidiBuffer midi;
+      double processMs = 0;
+
+      for (int start = 0; start + blockSize <= numSamples; start += blockSize) {
+        auto lfo =
+          0.5f + 0.5f * std::sin(juce::MathConstants<float>::twoPi * 2.f *
+                                 float(start / defaultSampleRate));
+
+        if (mode == AutomationMode_PeakSweep)
+          setParameter(
+            *processor, "Peak Freq", juce::mapToLog10(lfo, 100.f, 8000.f));
+        else if (mode == AutomationMode_Morph)
+          setParameter(*processor, "Morph", lfo);
+
+        for (int ch = 0; ch < 2; ++ch)
+          buffer.copyFrom(ch, 0, noise, ch, start, blockSize);
+
+        auto blockStart = getMilliseconds();
+        processor->processBlock(buffer, midi);
+        processMs += getMilliseconds() - blockStart;
+      }
+
+      const auto numBlocks = numSamples / blockSize;
+      std::cout << "  block " << blockSize << ", " << modeNames[mode] << ": "
+                << processMs * 1000.0 / numBlocks << " us/block, "
+                << processMs * 1.0e6 / (double(numBlocks) * blockSize)
+                << " ns/sample, " << seconds * 1000.0 / processMs
+                << "x realtime\n";
+    }
+  }
+}
+
+/* Times the output meter's pass on its own, on aligned buffers and on buffers
+   one sample off alignment, which take the scalar loop, against the whole of
+   processBlock, which includes it.
+*/
+void
+benchMeter(const juce::ArgumentList& args)
+{
+  const auto seconds = getIntOption(args, "--seconds", 10);
+  const auto numSamples = juce::roundToInt(seconds * defaultSampleRate);
+
+  juce::Random random(1);
+  const auto noise = makeNoise(2, numSamples + 1, random);
+
+  std::cout << seconds << " s of noise at " << defaultSampleRate << " Hz\n";
+
+  for (auto blockSize : { 64, 256, 1024 }) {
+    auto processor = makeProcessor(defaultSampleRate, blockSize);
+    setUpAutomationSettings(*processor);
+
+    StereoMeter meter;
+    meter.prepare(defaultSampleRate);
+
+    juce::AudioBuffer<float> buffer(2, blockSize + 1);
+    juce::MidiBuffer midi;
+    double processMs = 0, meterMs = 0, unalignedMeterMs = 0;
+
+    for (int start = 0; start + blockSize <= numSamples; start += blockSize) {
+      for (int ch = 0; ch < 2; ++ch)
+        buffer.copyFrom(ch, 0, noise, ch, start, blockSize + 1);
+
+      juce::AudioBuffer<float> block(
+        buffer.getArrayOfWritePointers(), 2, 0, blockSize);
+      juce::AudioBuffer<float> unaligned(
+        buffer.getArrayOfWritePointers(), 2, 1, blockSize);
+
+      auto blockStart = getMilliseconds();
+      meter.process(block);
+      meterMs += getMilliseconds() - blockStart;
+
+      blockStart = getMilliseconds();
+      meter.process(unaligned);
+      unalignedMeterMs += getMilliseconds() - blockStart;
+
+      blockStart = getMilliseconds();
+      processor->processBlock(block, midi);
+      processMs += getMilliseconds() - blockStart;
+    }
+
+    const auto numBlocks = numSamples / blockSize;
+    std::cout << "  block " << blockSize << ": meter "
+              << meterMs * 1000.0 / numBlocks << " us/block aligned, "
+              << unalignedMeterMs * 1000.0 / numBlocks
+              << " us/block unaligned, processBlock "
+              << processMs * 1000.0 / numBlocks << " us/block, meter share "
+              << 100.0 * meterMs / processMs << "%\n";
+  }
+}
+
+//==============================================================================
+/* Renders noise through renderOffline, in parallel chunks, and through the
+   same chains in one sequential pass with no chunks, in Stereo and Mid/Side
+   mode. The two have to agree within decayGain of the input's peak, plus an
+   allowance for float rounding, which doesn't start from the same state after
+   a warm-up. Then prints the speedup.
+*/
+void
+benchOffline(const juce::ArgumentList& args)
+{
+  const auto seconds = getIntOption(args, "--seconds", 60);
+  const auto numThreads =
+    getIntOption(args, "--threads", juce::SystemStats::getNumCpus());
+  const auto numSamples = juce::roundToInt(seconds * defaultSampleRate);
+
+  juce::Random random(1);
+  const auto input = makeNoise(2, numSamples, random);
+  const auto peak = input.getMagnitude(0, numSamples);
+
+  juce::ThreadPool pool(numThreads);
+
+  std::cout << seconds << " s of noise at " << defaultSampleRate << " Hz, "
+            << numThreads << " threads\n";
+
+  for (auto midSide : { false, true }) {
+    auto processor = makeProcessor(defaultSampleRate, defaultBlockSize);
+    setUpAutomationSettings(*processor);
+    setParameter(*processor, "Stereo Mode", midSide ? 1.f : 0.f);
+    setParameter(*processor, "Side Peak Gain", -6.f);
+
+    // what renderOffline renders with, morph off and the channels linked
+    OfflineRenderSettings sequential;
+    sequential.midSide = midSide;
+    sequential.sampleRate = defaultSampleRate;
+    sequential.minChunkSamples = std::numeric_limits<int>::max();
+
+    const auto main = getChainSettings(processor->apvts);
+    auto second = main;
+    if (midSide) {
+      second = getChainSettings(processor->apvts, SideParameters);
+      second.bands = main.bands;
+    }
+    sequential.chainSettings = { main, second };
+
+    juce::AudioBuffer<float> expected, rendered;
+
+    auto start = getMilliseconds();
+    OfflineRenderer::render(sequential, input, expected, pool);
+    const auto sequentialMs = getMilliseconds() - start;
+
+    start = getMilliseconds();
+    processor->renderOffline(input, rendered, pool);
+    const auto parallelMs = getMilliseconds() - start;
+
+    float maxError = 0;
+    for (int ch = 0; ch < 2; ++ch) {
+      const auto* a = expected.getReadPointer(ch);
+      const auto* b = rendered.getReadPointer(ch);
+      for (int i = 0; i < numSamples; ++i)
+        maxError = juce::jmax(maxError, std::abs(a[i] - b[i]));
+    }
+
+    const auto tolerance = peak * float(sequential.decayGain + 1e-5);
+    std::cout << "  " << (midSide ? "Mid/Side" : "Stereo")
+              << ": sequential " << sequentialMs << " ms, parallel "
+              << parallelMs << " ms, " << sequentialMs / parallelMs
+              << "x speedup, largest difference "
+              << juce::Decibels::gainToDecibels(maxError / peak)
+              << " dB below the peak\n";
+
+    if (maxError > tolerance)
+      juce::ConsoleApplication::fail(
+        "The parallel render differs from the sequential one by more than " +
+        juce::String(juce::Decibels::gainToDecibels(tolerance / peak)) +
+        " dB");
+  }
+}
+
+//==============================================================================
+double
+getMegabytes(size_t bytes)
+{
+  return double(bytes) / (1024.0 * 1024.0);
+}
+
+/* Opens and closes the editor, timing construction and the first paint, which
+   is when the response curve is designed and the background rendered or
+   fetched from the shared cache, on one instance and switching between
+   several. Then compares the memory of the instances with and without their
+   editors open.
+*/
+void
+benchEditor(const juce::ArgumentList& args)
+{
+  const auto iterations = getIntOption(args, "--iterations", 50);
+  const auto numInstances = getIntOption(args, "--instances", 20);
+
+  auto processor = makeProcessor(defaultSampleRate, defaultBlockSize);
+
+  auto openEditor = [&processor](double& constructMs, double& paintMs) {
+    auto start = getMilliseconds();
+    std::unique_ptr<juce::AudioProcessorEditor> editor(
+      processor->createEditorIfNeeded());
+    constructMs = getMilliseconds() - start;
+
+    start = getMilliseconds();
+    auto image = editor->createComponentSnapshot(editor->getLocalBounds());
+    paintMs = getMilliseconds() - start;
+  };
+
+  // the first open in the process renders the shared background
+  double firstConstructMs, firstPaintMs;
+  openEditor(firstConstructMs, firstPaintMs);
+
+  double constructMs = 0, paintMs = 0;
+  for (int i = 0; i < iterations; ++i) {
+    double construct, paint;
+    openEditor(construct, paint);
+    constructMs += construct;
+    paintMs += paint;
+  }
+  constructMs /= iterations;
+  paintMs /= iterations;
+
+  std::cout << "Editor open, " << iterations << " reopens\n"
+            << "  first:  construct " << firstConstructMs << " ms, first paint "
+            << firstPaintMs << " ms\n"
+            << "  reopen: construct " << constructMs << " ms, first paint "
+            << paintMs << " ms\n";
+
+  std::vector<std::unique_ptr<SimpleEqAudioProcessor>> processors;
+  for (int i = 0; i < numInstances; ++i)
+    processors.push_back(makeProcessor(defaultSampleRate, defaultBlockSize));
+
+  auto report = [&processors](const char* description) {
+    size_t ownBytes = 0, sharedBytes = 0;
+    for (auto& instance : processors) {
+      auto footprint = instance->getMemoryFootprint();
+      ownBytes += footprint.getTotalBytes(false);
+      sharedBytes =
+        footprint.getTotalBytes(true) - footprint.getTotalBytes(false);
+    }
+
+    // without sharing, every instance would hold its own copy
+    const auto numInstances = processors.size();
+    std::cout << "  " << description << ": "
+              << getMegabytes(ownBytes) / numInstances
+              << " MB per instance, " << getMegabytes(sharedBytes)
+              << " MB shared, saving "
+              << getMegabytes(sharedBytes * (numInstances - 1))
+              << " MB over unshared copies\n";
+  };
+
+  // switching tracks: each instance's editor in turn, the previous one
+  // closed first. only the first open in the process renders the background
+  double switchMs = 0, slowestSwitchMs = 0;
+  for (int i = 0; i < iterations; ++i) {
+    auto& instance = *processors[(size_t)i % processors.size()];
+
+    auto start = getMilliseconds();
+    std::unique_ptr<juce::AudioProcessorEditor> editor(
+      instance.createEditorIfNeeded());
+    editor->createComponentSnapshot(editor->getLocalBounds());
+    auto ms = getMilliseconds() - start;
+
+    switchMs += ms;
+    slowestSwitchMs = juce::jmax(slowestSwitchMs, ms);
+  }
+
+  std::cout << "  switching between " << numInstances
+            << " instances: open and first paint " << switchMs / iterations
+            << " ms on average, " << slowestSwitchMs << " ms at worst\n";
+
+  std::cout << numInstances << " instances\n";
+  report("editors closed");
+
+  std::vector<std::unique_ptr<juce::AudioProcessorEditor>> editors;
+  for (auto& instance : processors) {
+    editors.emplace_back(instance->createEditorIfNeeded());
+    editors.back()->createComponentSnapshot(editors.back()->getLocalBounds());
+  }
+  report("editors open");
+}
+
+/* Prints the memory report of an instance under each budget, with its editor
+   closed and open, after checking the budget comes back from a saved state.
+*/
+void
+benchFootprint(const juce::ArgumentList&)
+{
+  const char* budgetNames[] = { "Full", "Compact" };
+
+  for (auto budget : { MemoryBudget_Full, MemoryBudget_Compact }) {
+    auto processor = std::make_unique<SimpleEqAudioProcessor>();
+    processor->setMemoryBudget(budget);
+    ToolHelpers::prepareProcessor(
+      *processor, defaultSampleRate, defaultBlockSize);
+
+    juce::MemoryBlock state;
+    processor->getStateInformation(state);
+    SimpleEqAudioProcessor restored;
+    restored.setStateInformation(state.getData(), (int)state.getSize());
+    if (restored.getMemoryBudget() != budget)
+      juce::ConsoleApplication::fail(
+        juce::String(budgetNames[budget]) +
+        " budget didn't survive a state round trip");
+
+    std::cout << budgetNames[budget] << " budget, editor closed\n"
+              << processor->getMemoryFootprint().toString() << "\n";
+
+    std::unique_ptr<juce::AudioProcessorEditor> editor(
+      processor->createEditorIfNeeded());
+    editor->createComponentSnapshot(editor->getLocalBounds());
+
+    std::cout << budgetNames[budget] << " budget, editor open\n"
+              << processor->getMemoryFootprint().toString() << "\n";
+  }
+}
+
+//==============================================================================
+ResponseCurveComponent*
+findResponseCurve(juce::Component& editor)
+{
+  for (auto* child : editor.getChildren()) {
+    if (auto* curve = dynamic_cast<ResponseCurveComponent*>(child))
+      return curve;
+  }
+
+  return nullptr;
+}
+
+/* The message thread's cost of each analyzer view: the analysis run by the
+   timer, and painting the response curve, for a stream of noise. The quality
+   governor is pinned so every view runs the same FFT at the same rate.
+*/
+void
+benchGui(const juce::ArgumentList& args)
+{
+  const auto numFrames = getIntOption(args, "--frames", 600);
+  constexpr int frameRateHz = 60;
+
+  auto processor = makeProcessor(defaultSampleRate, defaultBlockSize);
+  std::unique_ptr<juce::AudioProcessorEditor> editor(
+    processor->createEditorIfNeeded());
+
+  auto* curve = findResponseCurve(*editor);
+  if (curve == nullptr)
+    juce::ConsoleApplication::fail("The editor has no response curve");
+
+  curve->setAnalyzerQualityBounds(
+    frameRateHz, frameRateHz, order2048, order2048);
+
+  juce::Image image(
+    juce::Image::ARGB, curve->getWidth(), curve->getHeight(), true);
+  juce::Graphics g(image);
+
+  const auto samplesPerFrame =
+    juce::roundToInt(defaultSampleRate / frameRateHz);
+  juce::Random random(1);
+  const auto noise = makeNoise(2, samplesPerFrame, random);
+
+  juce::AudioBuffer<float> buffer(2, defaultBlockSize);
+  juce::MidiBuffer midi;
+
+  auto runFrame = [&](double& analysisMs, double& paintMs) {
+    for (int start = 0; start < samplesPerFrame; start += defaultBlockSize) {
+      auto num = juce::jmin(defaultBlockSize, samplesPerFrame - start);
+      buffer.setSize(2, num, false, false, true);
+      for (int ch = 0; ch < 2; ++ch)
+        buffer.copyFrom(ch, 0, noise, ch, start, num);
+
+      processor->processBlock(buffer, midi);
+    }
+
+    auto start = getMilliseconds();
+    curve->timerCallback();
+    analysisMs += getMilliseconds() - start;
+
+    start = getMilliseconds();
+    curve->paintEntireComponent(g, false);
+    paintMs += getMilliseconds() - start;
+  };
+
+  const char* viewNames[] = {
+    "Output", "Input + Output", "Difference", "Waterfall"
+  };
+
+  std::cout << numFrames << " frames at " << frameRateHz
+            << " Hz, FFT order " << int(order2048) << ", "
+            << curve->getWidth() << "x" << curve->getHeight() << "\n";
+
+  for (auto view : { AnalyzerView_Output,
+                     AnalyzerView_InputAndOutput,
+                     AnalyzerView_Difference,
+                     AnalyzerView_Waterfall }) {
+    curve->setAnalyzerView(view);
+
+    // lets the analyzer fill its fifos and allocate what the view needs
+    double analysisMs = 0, paintMs = 0;
+    for (int i = 0; i < 10; ++i)
+      runFrame(analysisMs, paintMs);
+
+    analysisMs = paintMs = 0;
+    for (int i = 0; i < numFrames; ++i)
+      runFrame(analysisMs, paintMs);
+
+    analysisMs /= numFrames;
+    paintMs /= numFrames;
+    const auto frameBudgetMs = 1000.0 / frameRateHz;
+
+    std::cout << "  " << viewNames[view] << ": analysis " << analysisMs
+              << " ms, paint " << paintMs << " ms per frame, "
+              << 100.0 * (analysisMs + paintMs) / frameBudgetMs
+              << "% of a frame\n";
+  }
+}
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  // the processor's parameters and editor expect a message manager
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+  juce::ConsoleApplication app;
+
+  app.addHelpCommand("--help|-h", "ProcessorBench", false);
+  app.addCommand(
+    { "--state",
+      "--state [--iterations 10000]",
+      "Times saving and restoring the plugin state",
+      "Checks a binary state round trip reproduces every parameter, then "
+      "times getStateInformation and setStateInformation against the "
+      "ValueTree state.",
+      benchState });
+  app.addCommand(
+    { "--automation",
+      "--automation [--seconds 10]",
+      "Times processing under dense parameter automation",
+      "Processes noise at several block sizes while the peak frequency or the "
+      "morph amount is moved on every block, and with the settings held "
+      "still for comparison.",
+      benchAutomation });
+  app.addCommand(
+    { "--meter",
+      "--meter [--seconds 10]",
+      "Times the output meter's pass over the block",
+      "Processes noise at several block sizes and times StereoMeter::process "
+      "on aligned and unaligned buffers, against the whole of processBlock, "
+      "which includes it.",
+      benchMeter });
+  app.addCommand(
+    { "--offline",
+      "--offline [--seconds 60] [--threads <number of cores>]",
+      "Checks and times the parallel offline render",
+      "Renders noise through renderOffline and through one sequential pass, "
+      "in Stereo and Mid/Side mode. Fails if they differ by more than the "
+      "render's decayGain allows, and prints the speedup.",
+      benchOffline });
+  app.addCommand(
+    { "--editor",
+      "--editor [--iterations 50] [--instances 20]",
+      "Times opening the editor and measures memory per instance",
+      "Times the editor's construction and first paint, on the first open and "
+      "on reopens, then reports the memory of a number of instances with and "
+      "without their editors, and what they share.",
+      benchEditor });
+  app.addCommand(
+    { "--footprint",
+      "--footprint",
+      "Prints the memory report under each memory budget",
+      "Prints getMemoryFootprint() for the Full and Compact budgets, with the "
+      "editor closed and open, after checking the budget is restored from a "
+      "saved state.",
+      benchFootprint });
+  app.addCommand(
+    { "--gui",
+      "--gui [--frames 600]",
+      "Times the analyzer views on the message thread",
+      "Feeds noise through the processor and times the analysis and the paint "
+      "of each analyzer view, the line spectrum views against the waterfall.",
+      benchGui });
+
+  return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,414 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026
+
+    Offline spectrum analysis with the same FFT stage the editor's analyzer
+    uses. The file is streamed in batches of frames, each batch analysed by a
+    job on a thread pool, and written out in order as the batches finish.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "../../../Source/SpectrumAnalysis.h"
+
+#include <deque>
+
+namespace {
+// wider than the editor's display range, the quantised frames keep the detail
+constexpr float negativeInfinity = -120.f;
+constexpr float maxDecibels = 0.f;
+
+constexpr int framesPerBatch = 256;
+constexpr int pngHeight = 512;
+
+struct Options
+{
+  juce::File input, output, png;
+  FFTOrder order = order2048;
+  int hopSize = 0;
+  int numThreads = 0;
+  int pngWidth = 2048;
+};
+
+/* The .spec file: this header, then numFrames rows of numBins bytes, each the
+   decibel level quantised linearly from minDecibels (0) to maxDecibels (255),
+   then the long term average spectrum as numBins float decibels.
+*/
+struct SpectrogramHeader
+{
+  static constexpr juce::uint32 expectedMagic = 0x53514553; // "SEQS"
+  static constexpr juce::uint32 currentVersion = 1;
+
+  juce::uint32 magic, version, fftSize, hopSize, numBins, numFrames;
+  float sampleRate, minDecibels, maxDecibels;
+};
+
+static_assert(std::is_trivially_copyable_v<SpectrogramHeader>,
+              "the header is written straight to disk");
+
+/* A run of consecutive frames, read on the main thread and analysed by one
+   job on the pool.
+*/
+struct Batch
+{
+  juce::int64 firstFrame = 0;
+  int numFrames = 0;
+
+  juce::AudioBuffer<float> audio;
+  std::vector<float> workspace;
+  std::vector<float> decibels;
+
+  std::vector<juce::uint8> levels;
+  std::vector<double> powerSums;
+  double analysisSeconds = 0;
+
+  juce::WaitableEvent done;
+};
+
+juce::uint8
+quantise(float decibels)
+{
+  auto normalised =
+    (decibels - negativeInfinity) / (maxDecibels - negativeInfinity);
+  normalised = juce::jlimit(0.f, 1.f, normalised);
+  return (juce::uint8)juce::roundToInt(normalised * 255.f);
+}
+
+void
+analyseBatch(Batch& batch,
+             FFTOrder order,
+             int hopSize,
+             const juce::dsp::FFT& fft,
+             const juce::dsp::WindowingFunction<float>& window)
+{
+  const auto startTime = juce::Time::getMillisecondCounterHiRes();
+  const auto numBins = 1 << (order - 1);
+  const auto* mono = batch.audio.getReadPointer(0);
+
+  std::fill(batch.powerSums.begin(), batch.powerSums.end(), 0.0);
+
+  for (int frame = 0; frame < batch.numFrames; ++frame) {
+    computeSpectrum(mono + frame * hopSize,
+                    order,
+                    fft,
+                    window,
+                    batch.workspace.data(),
+                    batch.decibels.data(),
+                    negativeInfinity);
+
+    auto* levels = batch.levels.data() + frame * numBins;
+    for (int bin = 0; bin < numBins; ++bin) {
+      levels[bin] = quantise(batch.decibels[bin]);
+
+      auto magnitude = double(batch.workspace[bin]);
+      batch.powerSums[bin] += magnitude * magnitude;
+    }
+  }
+
+  batch.analysisSeconds =
+    (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+}
+
+/* Collects the finished batches in order: streams the levels to the .spec
+   file, sums the long term average and max-pools the frames into the PNG
+   columns on a log frequency axis.
+*/
+struct SpectrogramWriter
+{
+  SpectrogramWriter(const Options& options,
+                    double sampleRate,
+                    int hopSize,
+                    juce::uint32 numFrames)
+    : header{ SpectrogramHeader::expectedMagic,
+              SpectrogramHeader::currentVersion,
+              juce::uint32(1 << options.order),
+              juce::uint32(hopSize),
+              juce::uint32(1 << (options.order - 1)),
+              numFrames,
+              float(sampleRate),
+              negativeInfinity,
+              maxDecibels }
+    , totalPower(header.numBins, 0.0)
+  {
+    stream = std::make_unique<juce::FileOutputStream>(options.output);
+    if (!stream->openedOk())
+      juce::ConsoleApplication::fail("Couldn't write " +
+                                     options.output.getFullPathName());
+
+    stream->setPosition(0);
+    stream->truncate();
+    stream->write(&header, sizeof(header));
+
+    if (options.png != juce::File()) {
+      pngFile = options.png;
+      pngWidth = (int)juce::jmin(numFrames, (juce::uint32)options.pngWidth);
+      pngLevels.resize(size_t(pngWidth) * pngHeight, 0);
+
+      // top row is the highest frequency, same range as the editor
+      const auto binWidth = sampleRate / double(header.fftSize);
+      for (int y = 0; y < pngHeight; ++y) {
+        auto freq = juce::mapToLog10(
+          1.0 - double(y) / double(pngHeight - 1), 20.0, 20000.0);
+        rowBins[y] = juce::jlimit(
+          0, (int)header.numBins - 1, juce::roundToInt(freq / binWidth));
+      }
+    }
+  }
+
+  void write(const Batch& batch)
+  {
+    const auto numBins = (int)header.numBins;
+
+    stream->write(batch.levels.data(), size_t(batch.numFrames) * numBins);
+
+    for (int bin = 0; bin < numBins; ++bin)
+      totalPower[bin] += batch.powerSums[bin];
+
+    for (int frame = 0; frame < batch.numFrames && pngWidth > 0; ++frame) {
+      auto x = int((batch.firstFrame + frame) * pngWidth / header.numFrames);
+      const auto* levels = batch.levels.data() + frame * numBins;
+
+      for (int y = 0; y < pngHeight; ++y) {
+        auto& pixel = pngLevels[size_t(y) * pngWidth + x];
+        pixel = juce::jmax(pixel, levels[rowBins[y]]);
+      }
+    }
+  }
+
+  // appends the long term average spectrum and writes the PNG
+  bool finish()
+  {
+    for (auto power : totalPower) {
+      auto average = float(std::sqrt(power / double(header.numFrames)));
+      auto decibels = juce::Decibels::gainToDecibels(average, negativeInfinity);
+      stream->write(&decibels, sizeof(decibels));
+    }
+
+    stream->flush();
+    if (stream->getStatus().failed())
+      return false;
+
+    return pngWidth == 0 || writePng();
+  }
+
+private:
+  SpectrogramHeader header;
+  std::unique_ptr<juce::FileOutputStream> stream;
+  std::vector<double> totalPower;
+
+  juce::File pngFile;
+  int pngWidth = 0;
+  std::vector<juce::uint8> pngLevels;
+  std::array<int, pngHeight> rowBins{};
+
+  bool writePng() const
+  {
+    juce::ColourGradient palette(
+      juce::Colours::black, 0, 0, juce::Colours::yellow, 1, 0, false);
+    palette.addColour(0.4, juce::Colours::darkblue);
+    palette.addColour(0.7, juce::Colours::red);
+
+    std::array<juce::Colour, 256> colours;
+    for (int i = 0; i < 256; ++i)
+      colours[i] = palette.getColourAtPosition(i / 255.0);
+
+    juce::Image image(juce::Image::RGB, pngWidth, pngHeight, false);
+    {
+      juce::Image::BitmapData pixels(
+        image, juce::Image::BitmapData::writeOnly);
+      for (int y = 0; y < pngHeight; ++y) {
+        for (int x = 0; x < pngWidth; ++x)
+          pixels.setPixelColour(
+            x, y, colours[pngLevels[size_t(y) * pngWidth + x]]);
+      }
+    }
+
+    pngFile.deleteFile();
+    juce::FileOutputStream pngStream(pngFile);
+    juce::PNGImageFormat png;
+    return pngStream.openedOk() && png.writeImageToStream(image, pngStream);
+  }
+};
+
+Options
+parseOptions(const juce::ArgumentList& args)
+{
+  Options options;
+
+  if (args.size() == 0)
+    juce::ConsoleApplication::fail("No input file given");
+
+  options.input = args[0].resolveAsExistingFile();
+  options.output = args.containsOption("--out")
+                     ? args.getFileForOption("--out")
+                     : options.input.withFileExtension("spec");
+
+  if (args.containsOption("--png"))
+    options.png = args.getFileForOption("--png");
+
+  if (args.containsOption("--order")) {
+    auto order = args.getValueForOption("--order").getIntValue();
+    if (order < order1024 || order > order8192)
+      juce::ConsoleApplication::fail("--order must be between 10 and 13");
+    options.order = static_cast<FFTOrder>(order);
+  }
+
+  // half overlapping frames unless told otherwise
+  options.hopSize = args.containsOption("--hop")
+                      ? args.getValueForOption("--hop").getIntValue()
+                      : (1 << options.order) / 2;
+  if (options.hopSize <= 0)
+    juce::ConsoleApplication::fail("--hop must be positive");
+
+  options.numThreads = args.containsOption("--threads")
+                         ? args.getValueForOption("--threads").getIntValue()
+                         : juce::SystemStats::getNumCpus();
+  options.numThreads = juce::jmax(1, options.numThreads);
+
+  if (args.containsOption("--png-width")) {
+    options.pngWidth =
+      juce::jmax(1, args.getValueForOption("--png-width").getIntValue());
+  }
+
+  return options;
+}
+
+void
+run(const juce::ArgumentList& args)
+{
+  const auto options = parseOptions(args);
+
+  juce::AudioFormatManager formatManager;
+  formatManager.registerBasicFormats();
+
+  std::unique_ptr<juce::AudioFormatReader> reader(
+    formatManager.createReaderFor(options.input));
+  if (reader == nullptr)
+    juce::ConsoleApplication::fail("Couldn't read " +
+                                   options.input.getFullPathName());
+
+  const auto order = options.order;
+  const auto fftSize = 1 << order;
+  const auto numBins = fftSize / 2;
+  const auto hopSize = options.hopSize;
+  const auto numChannels = juce::jmax(1, (int)reader->numChannels);
+  const auto length = reader->lengthInSamples;
+
+  // the last frame is zero padded rather than dropped
+  const auto numFrames =
+    1 + (juce::jmax(juce::int64(0), length - fftSize) + hopSize - 1) / hopSize;
+  if (numFrames > std::numeric_limits<juce::uint32>::max())
+    juce::ConsoleApplication::fail("Input is too long for the hop size");
+
+  juce::SharedResourcePointer<SharedFFTResources> fftResources;
+  const auto& fft = fftResources->getFFT(order);
+  const auto& window = fftResources->getWindow(order);
+
+  SpectrogramWriter writer(
+    options, reader->sampleRate, hopSize, (juce::uint32)numFrames);
+
+  juce::ThreadPool pool(options.numThreads);
+
+  // enough batches queued to keep every thread busy while the oldest is
+  // written, without holding the whole file in memory
+  const auto maxBatchesInFlight = (size_t)options.numThreads * 2;
+  std::deque<std::unique_ptr<Batch>> inFlight;
+  std::vector<std::unique_ptr<Batch>> spare;
+
+  double analysisSeconds = 0;
+  const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+  auto writeOldest = [&] {
+    auto batch = std::move(inFlight.front());
+    inFlight.pop_front();
+
+    batch->done.wait();
+    writer.write(*batch);
+    analysisSeconds += batch->analysisSeconds;
+
+    spare.push_back(std::move(batch));
+  };
+
+  for (juce::int64 first = 0; first < numFrames; first += framesPerBatch) {
+    if (inFlight.size() >= maxBatchesInFlight)
+      writeOldest();
+
+    std::unique_ptr<Batch> batch;
+    if (spare.empty()) {
+      const auto maxSamples = (framesPerBatch - 1) * hopSize + fftSize;
+
+      batch = std::make_unique<Batch>();
+      batch->audio.setSize(numChannels, maxSamples);
+      batch->workspace.resize(size_t(fftSize) * 2);
+      batch->decibels.resize(numBins);
+      batch->levels.resize(size_t(framesPerBatch) * numBins);
+      batch->powerSums.resize(numBins);
+    } else {
+      batch = std::move(spare.back());
+      spare.pop_back();
+    }
+
+    batch->firstFrame = first;
+    batch->numFrames = (int)juce::jmin(juce::int64(framesPerBatch),
+                                       numFrames - first);
+
+    // mixed down to mono in the first channel, reads past the end are silent
+    const auto numSamples = (batch->numFrames - 1) * hopSize + fftSize;
+    auto& audio = batch->audio;
+    reader->read(&audio, 0, numSamples, first * hopSize, true, true);
+
+    for (int ch = 1; ch < numChannels; ++ch)
+      audio.addFrom(0, 0, audio, ch, 0, numSamples);
+    if (numChannels > 1)
+      audio.applyGain(0, 0, numSamples, 1.f / float(numChannels));
+
+    auto& job = *batch;
+    pool.addJob([&job, order, hopSize, &fft, &window] {
+      analyseBatch(job, order, hopSize, fft, window);
+      job.done.signal();
+    });
+
+    inFlight.push_back(std::move(batch));
+  }
+
+  while (!inFlight.empty())
+    writeOldest();
+
+  const auto seconds =
+    (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+  if (!writer.finish())
+    juce::ConsoleApplication::fail("Couldn't finish writing the output");
+
+  std::cout << numFrames << " frames of " << fftSize << " samples, hop "
+            << hopSize << ", in " << seconds << " s on " << options.numThreads
+            << " threads\n"
+            << "  " << numFrames / seconds << " frames/sec, "
+            << numFrames / (seconds * options.numThreads)
+            << " frames/sec/core overall\n"
+            << "  " << numFrames / juce::jmax(analysisSeconds, 1e-9)
+            << " frames/sec/core in the analysis jobs\n";
+}
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  juce::ConsoleApplication app;
+
+  app.addHelpCommand("--help|-h", "SpectrumTool", false);
+  app.addDefaultCommand(
+    { "",
+      "<input> [--out file.spec] [--png file.png] [--png-width 2048] "
+      "[--order 10-13] [--hop samples] [--threads n]",
+      "Writes the spectrogram and long term average spectrum of a file",
+      "Frames are analysed like the SimpleEq analyzer, a Blackman-Harris "
+      "window and a magnitude FFT, in batches spread over a thread pool.",
+      run });
+
+  return app.findAndRunCommand(argc, argv);
+}